@@ -12,6 +12,10 @@ public:
     void SetPerspective(float fovDeg, float aspect, float nearZ, float farZ) {
         fov = fovDeg; aspectRatio = aspect; nearPlane = nearZ; farPlane = farZ;
     }
+    float GetFov() const { return fov; }
+    float GetAspect() const { return aspectRatio; }
+    float GetNear() const { return nearPlane; }
+    float GetFar() const { return farPlane; }
     void SetActive(bool enabled) { active = enabled; }
     bool IsActive() const { return active; }
 
@@ -0,0 +1,102 @@
+#pragma once
+// ---------------------------------------------------------------------------
+//  CpuProfiler — scoped timing zones, exported as a Chrome trace.
+//
+//      void Scene::UpdateScene(float dt) {
+//          CpuProfiler::Scope zone("Scene::UpdateScene");
+//          ...
+//      }
+//
+//  Each thread writes its zones into its own ring buffer, so recording
+//  takes no lock; the ring keeps the last kEventsPerThread zones, which
+//  covers the last few seconds of frames.  A dump (on the hotkey, after a
+//  set number of frames, or WriteTrace) writes them in Chrome trace_event
+//  JSON, for chrome://tracing or ui.perfetto.dev.
+//
+//  Zone names must be string literals (or otherwise outlive the profiler):
+//  only the pointer is stored.  Recording is on by default; a disabled
+//  Scope is one flag test.
+// ---------------------------------------------------------------------------
+
+#include <SDL.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class CpuProfiler {
+public:
+    static CpuProfiler& Get();
+
+    void SetEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+    bool IsEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    /// Label the calling thread in the trace.
+    static void SetThreadName(const char* name);
+
+    /// Key that dumps the trace to the default path (SDLK_UNKNOWN to disable).
+    void SetDumpKey(SDL_Keycode key) { m_dumpKey = key; }
+    /// Handles the dump key; the dump itself happens at the next EndFrame.
+    void ProcessEvent(const SDL_Event& event);
+
+    /// Dump once `frames` more frames have ended.
+    void DumpAfterFrames(int frames, const std::string& path = kDefaultTracePath);
+    /// Dump at the end of the current frame.
+    void RequestDump(const std::string& path = kDefaultTracePath);
+
+    /// Called by the engine once per frame; performs requested dumps.
+    void EndFrame();
+
+    /// Write every recorded zone as Chrome trace JSON.  False if the file
+    /// can't be written.
+    bool WriteTrace(const std::string& path);
+
+    /// Times its own lifetime on the calling thread.
+    class Scope {
+    public:
+        explicit Scope(const char* name);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        const char* m_name;
+        int64_t m_start;
+    };
+
+    static constexpr const char* kDefaultTracePath = "trace.json";
+    static constexpr size_t kEventsPerThread = 1 << 16;
+
+private:
+    CpuProfiler();
+
+    struct Event {
+        const char* name;
+        int64_t start;       // ns, steady clock
+        int64_t duration;    // ns
+    };
+    struct ThreadBuffer {
+        std::unique_ptr<Event[]> events;
+        std::atomic<uint64_t> head{0};   // total events written; slot = head % kEventsPerThread
+        int id = 0;
+        std::string name;
+    };
+
+    static thread_local ThreadBuffer* t_buffer;   // the calling thread's ring
+
+    static int64_t now();
+    ThreadBuffer& threadBuffer();
+    void record(const char* name, int64_t start, int64_t end);
+
+    std::atomic<bool> m_enabled{true};
+    int64_t m_epoch;
+
+    std::mutex m_threadsMutex;                       // guards registration and names
+    std::vector<std::unique_ptr<ThreadBuffer>> m_threads;
+
+    SDL_Keycode m_dumpKey = SDLK_F9;
+    int m_framesUntilDump = 0;                       // 0 = none scheduled
+    bool m_dumpRequested = false;
+    std::string m_dumpPath = kDefaultTracePath;
+};
@@ -0,0 +1,67 @@
+#pragma once
+#include <GL/glew.h>
+#include <string>
+#include <vector>
+
+/// Glyphs of a font rasterised once into a shared GL texture.
+///
+/// The atlas is built on first use: every printable ASCII glyph is rendered
+/// in white with SDL_ttf and shelf-packed into one RGBA texture.
+/// TextComponent lays strings out as glyph quads and draws them through
+/// SpriteBatch with a per-quad colour, so changing a label never creates a
+/// texture and all text sharing an atlas batches into a single draw.
+/// Characters outside the printable ASCII range are drawn as '?'.
+///
+/// Two kinds of atlas exist:
+///   - bitmap (Get): coverage at one pixel size, exact at that size only;
+///   - distance field (GetDistanceField): one per font, alpha stores the
+///     signed distance to the glyph edge, so SpriteBatch's distance-field
+///     style draws it sharp at any size, rotation, and with an outline.
+class FontAtlas {
+public:
+    /// Metrics are in atlas pixels; multiply by GetScale() for a text size.
+    struct Glyph {
+        float u0 = 0, v0 = 0, u1 = 0, v1 = 0;   // rect in the atlas
+        int offsetX = 0, offsetY = 0;           // quad origin from the pen position / line top
+        int width = 0, height = 0;              // quad size (0 = nothing to draw)
+        int advance = 0;                        // pen advance
+    };
+
+    /// Shared bitmap atlas for a font file in the default archive at a pixel
+    /// size.  Never null; GetTextureID() is 0 if the font could not be loaded.
+    static FontAtlas* Get(const std::string& fontFile, int size);
+    /// Shared distance-field atlas for a font file, usable at every size.
+    static FontAtlas* GetDistanceField(const std::string& fontFile);
+
+    /// Delete every atlas texture.  Call before the GL context is destroyed.
+    static void ReleaseAll();
+
+    const Glyph& GetGlyph(char c) const;
+    GLuint GetTextureID() const { return m_texture; }
+    int GetLineHeight() const { return m_lineHeight; }
+    bool IsDistanceField() const { return m_spread > 0; }
+    /// Atlas-to-screen factor for text of `pixelSize` (1 for a bitmap atlas).
+    float GetScale(int pixelSize) const { return IsDistanceField() ? pixelSize / (float)m_rasterSize : 1.0f; }
+    /// Distance, in atlas pixels, between alpha 0.5 and alpha 0 or 1.
+    int GetSpread() const { return m_spread; }
+
+    ~FontAtlas();
+
+private:
+    FontAtlas() = default;
+    bool build(const std::vector<unsigned char>& fontData, int size, int spread);
+
+    static constexpr int kFirstChar  = 32;
+    static constexpr int kLastChar   = 126;
+    static constexpr int kGlyphCount = kLastChar - kFirstChar + 1;
+    static constexpr int kAtlasWidth = 512;
+    static constexpr int kPadding    = 1;   // keeps linear filtering from bleeding
+    static constexpr int kDistanceFieldSize   = 48;   // raster size of distance-field atlases
+    static constexpr int kDistanceFieldSpread = 6;
+
+    Glyph m_glyphs[kGlyphCount];
+    GLuint m_texture = 0;
+    int m_lineHeight = 0;
+    int m_rasterSize = 0;
+    int m_spread = 0;
+};
@@ -0,0 +1,45 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+class LightComponent;
+
+/// Per-frame camera and light data shared by every 3D shader through one
+/// std140 uniform block, "FrameData", at binding point kBindingPoint.
+///
+/// RenderSystem fills it once per frame before the 3D passes.
+/// ResourceManager binds the block of every program that declares it when
+/// the program is linked, so shaders only keep per-draw uniforms.
+class FrameUniforms {
+public:
+    static constexpr GLuint kBindingPoint = 0;
+
+    /// GLSL declaration of the block; paste it right after #version.
+    static const char* const kBlockSource;
+
+    static FrameUniforms& Get();
+
+    /// Rewrite the block for this frame (light may be null).
+    void Update(const glm::mat4& view, const glm::mat4& projection, const LightComponent* light);
+
+    /// Delete the buffer.  Call before the GL context is destroyed.
+    void Release();
+
+private:
+    FrameUniforms() = default;
+
+    /// CPU mirror of the block, laid out by std140 rules.
+    struct Block {
+        glm::mat4 view;
+        glm::mat4 projection;
+        glm::mat4 lightVPs[4];
+        glm::vec4 cascadeSplits;    // view-space far distance of each cascade
+        glm::vec4 lightDir;         // xyz
+        glm::vec4 lightColor;       // rgb
+        glm::vec4 ambientColor;     // rgb
+        glm::ivec4 shadowParams;    // x = useShadows, y = cascadeCount, z = PCF taps (x, z unread: see ShaderFeatures)
+    };
+    static_assert(sizeof(Block) == 6 * 64 + 5 * 16, "FrameData must match the std140 layout");
+
+    GLuint m_ubo = 0;
+};
@@ -56,4 +56,60 @@ struct Frustum {
         }
         return true;
     }
+
+    // ── Hierarchical culling ─────────────────────────────────────────────
+
+    enum Classification { Outside = 0, Intersecting, Inside };
+    static constexpr unsigned kAllPlanes = 0x3F;
+    static constexpr unsigned kNearPlane = 1u << 4;
+
+    /// TestAABB against only the planes whose bit is set in `planeMask`
+    /// (e.g. kAllPlanes & ~kNearPlane for shadow casters behind the light).
+    bool TestAABB(const glm::vec3& mn, const glm::vec3& mx, unsigned planeMask) const {
+        for (int i = 0; i < 6; ++i) {
+            if ((planeMask & (1u << i)) && outsidePlane(i, mn, mx))
+                return false;
+        }
+        return true;
+    }
+
+    /// Classify an AABB against the planes whose bit is set in `planeMask`.
+    ///
+    /// `lastPlane` is a per-node coherence hint: the plane that rejected this
+    /// node last frame is tested first, and is updated whenever a plane
+    /// rejects it.  On return `planeMask` keeps only the planes the box
+    /// straddles, so children of an intersecting node can skip planes their
+    /// parent is already fully inside of.
+    Classification ClassifyAABB(const glm::vec3& mn, const glm::vec3& mx,
+                                unsigned& planeMask, int& lastPlane) const {
+        if (lastPlane >= 0 && (planeMask & (1u << lastPlane)) && outsidePlane(lastPlane, mn, mx))
+            return Outside;
+        unsigned straddled = 0;
+        for (int i = 0; i < 6; ++i) {
+            if (!(planeMask & (1u << i))) continue;
+            if (i != lastPlane && outsidePlane(i, mn, mx)) {
+                lastPlane = i;
+                return Outside;
+            }
+            if (!insidePlane(i, mn, mx)) straddled |= 1u << i;
+        }
+        planeMask = straddled;
+        return straddled ? Intersecting : Inside;
+    }
+
+private:
+    // Nearest corner (along the plane normal) is behind the plane.
+    bool outsidePlane(int i, const glm::vec3& mn, const glm::vec3& mx) const {
+        glm::vec3 p((planes[i].x >= 0.0f) ? mx.x : mn.x,
+                    (planes[i].y >= 0.0f) ? mx.y : mn.y,
+                    (planes[i].z >= 0.0f) ? mx.z : mn.z);
+        return glm::dot(glm::vec3(planes[i]), p) + planes[i].w < 0.0f;
+    }
+    // Farthest corner (against the plane normal) is in front of the plane.
+    bool insidePlane(int i, const glm::vec3& mn, const glm::vec3& mx) const {
+        glm::vec3 n((planes[i].x >= 0.0f) ? mn.x : mx.x,
+                    (planes[i].y >= 0.0f) ? mn.y : mx.y,
+                    (planes[i].z >= 0.0f) ? mn.z : mx.z);
+        return glm::dot(glm::vec3(planes[i]), n) + planes[i].w >= 0.0f;
+    }
 };
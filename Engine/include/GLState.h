@@ -0,0 +1,143 @@
+#pragma once
+// ---------------------------------------------------------------------------
+//  GLState — shadow copy of the GL binding and pipeline state, so redundant
+//  state changes never reach the driver.
+//
+//  Recorded render commands change state through it instead of calling GL:
+//
+//      GLState& gl = GLState::Get();
+//      gl.UseProgram(prog);                       // skipped if already bound
+//      gl.BindTexture(0, GL_TEXTURE_2D, albedo);  // selects the unit itself
+//      gl.SetUniform(u.ourTexture, 0);            // skipped if already 0
+//      gl.BindVertexArray(vao);
+//
+//  Since nothing is re-bound needlessly, draws no longer reset bindings
+//  (program 0, VAO 0) when they finish.  Uniform values are remembered per
+//  program and location, so per-draw sampler and tint uniforms cost
+//  nothing when they repeat.
+//
+//  GL-thread only: call it inside recorded commands (see RenderThread), or
+//  while holding the context before the render thread starts.  Resource
+//  code under a GLContextLock binds objects directly; releasing the
+//  outermost lock forgets the object bindings (InvalidateBindings), so the
+//  next bind of each is issued.  Pipeline state and uniform values are
+//  kept: resource code never changes them.
+//
+//  A new object can reuse the name of a deleted one that the copy still
+//  thinks is bound, so whoever creates names passes them to Forget().
+// ---------------------------------------------------------------------------
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+class GLState {
+public:
+    static GLState& Get();
+
+    /// Kinds of state, for Forget() and the statistics.
+    enum Kind { KindProgram, KindVertexArray, KindTexture, KindBuffer, KindFramebuffer,
+                KindCapability, KindPipeline, KindUniform, KindCount };
+
+    // ── Bindings ─────────────────────────────────────────────────────────────
+    void UseProgram(GLuint program);
+    void BindVertexArray(GLuint vao);
+    /// Bind `texture` to `unit`, making it the active unit if it isn't.
+    void BindTexture(GLuint unit, GLenum target, GLuint texture);
+    /// GL_ARRAY_BUFFER and GL_UNIFORM_BUFFER are tracked; other targets are
+    /// passed through.  (The element buffer belongs to the bound VAO.)
+    void BindBuffer(GLenum target, GLuint buffer);
+    /// GL_FRAMEBUFFER binds both the draw and the read framebuffer.
+    void BindFramebuffer(GLenum target, GLuint framebuffer);
+
+    // ── Pipeline ─────────────────────────────────────────────────────────────
+    /// glEnable / glDisable.
+    void SetEnabled(GLenum capability, bool enabled);
+    void BlendFunc(GLenum source, GLenum destination);
+    void DepthFunc(GLenum func);
+    void CullFace(GLenum mode);
+    void Viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+    // ── Uniforms of the bound program ────────────────────────────────────────
+    // A location of -1 (inactive in this program variant) is ignored.
+    void SetUniform(GLint location, int value);
+    void SetUniform(GLint location, float value);
+    void SetUniform(GLint location, const glm::vec3& value);
+    void SetUniform(GLint location, const glm::vec4& value);
+    void SetUniform(GLint location, const glm::mat3& value);
+    void SetUniform(GLint location, const glm::mat4& value);
+
+    /// Forget everything; the next change of each kind is issued.
+    void Invalidate();
+    /// Forget the object bindings resource code may have changed: buffers,
+    /// VAO, framebuffers and the textures of the active unit.
+    void InvalidateBindings();
+    /// Forget newly created names of a kind (program, VAO, texture, buffer
+    /// or framebuffer) wherever the copy has them bound.  A program's
+    /// uniform values are dropped too: a new program starts from defaults.
+    void Forget(Kind kind, const GLuint* names, int count);
+
+    // ── Statistics ───────────────────────────────────────────────────────────
+    static const char* GetKindName(Kind kind);
+
+    /// Publish this frame's counts and start the next frame.  Record it once
+    /// per frame, after the last draw.
+    void EndFrame();
+
+    /// State changes of a kind issued to GL / skipped as redundant during
+    /// the last completed frame (readable from any thread).
+    int GetIssued(Kind kind) const { return m_lastIssued[kind].load(std::memory_order_relaxed); }
+    int GetSkipped(Kind kind) const { return m_lastSkipped[kind].load(std::memory_order_relaxed); }
+    int GetTotalIssued() const;
+    int GetTotalSkipped() const;
+    /// One-line summary, e.g. for an overlay.
+    std::string FormatSummary() const;
+
+    static constexpr int kTextureUnits = 8;   // units tracked (the engine uses 0 and 1)
+
+private:
+    GLState() { Invalidate(); }
+
+    static constexpr GLuint kUnknown = ~0u;
+
+    // Count a change; true if it must be issued
+    bool changed(Kind kind, bool differs) {
+        (differs ? m_issued : m_skipped)[kind]++;
+        return differs;
+    }
+    void activeTexture(GLuint unit);
+    int* capabilitySlot(GLenum capability);
+
+    // Raw bytes of a uniform's last value; true if `data` differs from it
+    bool uniformChanged(GLint location, const void* data, size_t size);
+
+    GLuint m_program;
+    GLuint m_vao;
+    GLuint m_activeUnit;
+    GLuint m_textures2D[kTextureUnits];
+    GLuint m_textures2DArray[kTextureUnits];
+    GLuint m_arrayBuffer;
+    GLuint m_uniformBuffer;
+    GLuint m_drawFramebuffer;
+    GLuint m_readFramebuffer;
+
+    // -1 = unknown, else 0/1
+    int m_depthTest, m_blend, m_cullFace, m_scissorTest, m_depthClamp;
+    GLenum m_blendSource, m_blendDestination, m_depthFunc, m_cullMode;
+    GLint m_viewport[4];
+
+    struct UniformValue {
+        uint32_t size = 0;
+        float data[16];
+    };
+    // Keyed by (program << 32 | location)
+    std::unordered_map<uint64_t, UniformValue> m_uniforms;
+
+    int m_issued[KindCount] = {};
+    int m_skipped[KindCount] = {};
+    std::atomic<int> m_lastIssued[KindCount] = {};
+    std::atomic<int> m_lastSkipped[KindCount] = {};
+};
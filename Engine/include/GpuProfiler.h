@@ -0,0 +1,83 @@
+#pragma once
+// ---------------------------------------------------------------------------
+//  GpuProfiler — GPU time of each render pass, from GL_TIME_ELAPSED queries.
+//
+//  Passes are bracketed with a Scope; a pass may be entered several times a
+//  frame (the model pass runs between 2D layers) and its segments add up.
+//  Queries go into a ring of kFrameLatency frames and are read back when
+//  their frame comes round again, only if the result is already available,
+//  so reading never stalls the pipeline.  Timings are a few frames old and
+//  smoothed.
+//
+//      { GpuProfiler::Scope gpu(GpuProfiler::PassShadow); ...draws... }
+//      GpuProfiler::Get().EndFrame();    // once per frame, after the last pass
+//      float ms = GpuProfiler::Get().GetPassMs(GpuProfiler::PassShadow);
+//
+//  Disabled by default: a disabled Scope is one flag test and records
+//  nothing.  All GL work is recorded (see RenderThread), so the queries
+//  live on whichever thread executes the frame.
+// ---------------------------------------------------------------------------
+
+#include <GL/glew.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+class GpuProfiler {
+public:
+    enum Pass { PassShadow, PassVoxels, PassModels, PassOverlay, PassCount };
+
+    static GpuProfiler& Get();
+
+    void SetEnabled(bool enabled);
+    bool IsEnabled() const { return m_enabled; }
+
+    /// Close the frame's queries and collect a finished older frame.
+    void EndFrame();
+
+    /// Smoothed GPU milliseconds of a pass (0 until results arrive).
+    float GetPassMs(Pass pass) const { return m_passMs[pass].load(std::memory_order_relaxed); }
+    /// Sum of every pass.
+    float GetTotalMs() const;
+    static const char* GetPassName(Pass pass);
+    /// One-line summary, e.g. for an overlay.
+    std::string FormatSummary() const;
+
+    /// Delete the query objects.  Call before the GL context is destroyed.
+    void Release();
+
+    /// Times the GPU work recorded during its lifetime as part of `pass`.
+    class Scope {
+    public:
+        explicit Scope(Pass pass);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        bool m_active;
+    };
+
+    static constexpr int kFrameLatency = 3;   // frames in flight before a result is read
+
+private:
+    GpuProfiler() = default;
+
+    // GL-thread side (touched only inside recorded commands)
+    void beginQuery(Pass pass);
+    void endQuery();
+    void collect(int frame);
+
+    struct Segment {
+        GLuint query;
+        Pass pass;
+    };
+    struct FrameQueries {
+        std::vector<GLuint> pool;          // grows to the most segments a frame has used
+        std::vector<Segment> issued;       // this frame's segments, in order
+    };
+    FrameQueries m_frames[kFrameLatency];
+    int m_frame = 0;
+
+    bool m_enabled = false;
+    std::atomic<float> m_passMs[PassCount] = {};
+};
@@ -0,0 +1,37 @@
+#pragma once
+#include "component.h"
+#include "object.h"
+#include "text.h"
+#include "GpuProfiler.h"
+
+// Shows GpuProfiler's per-pass timings in the TextComponent on the same
+// object.  Turns the profiler on while it exists.
+class GpuProfilerOverlay : public Component {
+public:
+    explicit GpuProfilerOverlay(float refreshInterval = 0.25f)
+        : refreshInterval(refreshInterval) {}
+
+    ~GpuProfilerOverlay() override {
+        GpuProfiler::Get().SetEnabled(false);
+    }
+
+    void Init() override {
+        GpuProfiler::Get().SetEnabled(true);
+    }
+
+    void Update(float deltaTime) override {
+        if (!object) return;
+        sinceRefresh += deltaTime;
+        if (sinceRefresh < refreshInterval) return;
+        sinceRefresh = 0.0f;
+
+        if (auto* text = object->GetComponent<TextComponent>())
+            text->setText(GpuProfiler::Get().FormatSummary());
+    }
+
+    Component* Clone() const override { return new GpuProfilerOverlay(*this); }
+
+private:
+    float refreshInterval;
+    float sinceRefresh = 0.0f;
+};
@@ -9,24 +9,43 @@
 
 #include <GL/glew.h>
 #include <glm/glm.hpp>
+#include <vector>
 #include "Frustum.h"
 
 class LightComponent;
 
 class IVoxelRenderer {
 public:
+    /// Shadow cascades a light may render (each gets its own cull state).
+    static constexpr int kMaxShadowCascades = 4;
+
     virtual ~IVoxelRenderer() = default;
 
-    /// Render every loaded chunk mesh (main colour pass).
-    virtual void RenderChunks(const glm::mat4& view,
-                              const glm::mat4& projection,
-                              LightComponent* light,
+    /// Render every loaded chunk mesh (main colour pass).  Camera and light
+    /// parameters come from the per-frame FrameData block; `light` supplies
+    /// the shadow map.
+    virtual void RenderChunks(LightComponent* light,
                               const Frustum& frustum) = 0;
 
-    /// Render every loaded chunk mesh into the shadow depth buffer.
+    /// Render every loaded chunk mesh into one shadow cascade's depth layer.
     virtual void RenderChunksDepth(GLuint depthProgram,
                                    const glm::mat4& lightVP,
-                                   const Frustum& lightFrustum) = 0;
+                                   const Frustum& lightFrustum,
+                                   int cascade) = 0;
+
+    /// World-space box whose chunk geometry changed.
+    struct Bounds {
+        glm::vec3 min;
+        glm::vec3 max;
+    };
+
+    /// Move the bounds of every chunk rebuilt or removed since the last call
+    /// into `out` (replacing its contents).  Used by the shadow cache to
+    /// re-render only the affected part of the static shadow layer.
+    /// Returns true, with `out` empty, when the changes weren't tracked
+    /// individually (the world was cleared, or too much changed): the whole
+    /// static layer must be redrawn.
+    virtual bool TakeChangedBounds(std::vector<Bounds>& out) { out.clear(); return false; }
 
     /// Global instance — set by the active voxel world component.
     static inline IVoxelRenderer* s_instance = nullptr;  // C++17
@@ -1,12 +1,18 @@
 #pragma once
 #include "component.h"
+#include "IVoxelRenderer.h"
 #include <glm/glm.hpp>
 #include <GL/glew.h>
+#include <vector>
 
 class Scene;
+class Object;
+class Model3DComponent;
 
 class LightComponent : public Component {
 public:
+    static constexpr int kMaxCascades = IVoxelRenderer::kMaxShadowCascades;
+
     LightComponent();
     ~LightComponent();
 
@@ -16,26 +22,87 @@ public:
     void SetColor(const glm::vec3& col) { color = col; }
     void SetAmbient(const glm::vec3& amb) { ambient = amb; }
     void SetShadowEnabled(bool enabled) { enableShadows = enabled; }
+    /// Resolution of each cascade layer.
     void SetShadowMapSize(int w, int h) { shadowWidth = w; shadowHeight = h; }
+    /// Number of shadow cascades (clamped to 1..kMaxCascades, 2-4 is typical).
+    void SetCascadeCount(int n) { cascadeCount = n < 1 ? 1 : (n > kMaxCascades ? kMaxCascades : n); }
+    /// Practical split scheme blend: 0 = uniform splits, 1 = logarithmic.
+    void SetCascadeSplitLambda(float lambda) { splitLambda = lambda; }
+    /// View distance covered by the last cascade (clamped to the camera far plane).
+    void SetShadowDistance(float d) { shadowDistance = d; }
+    /// Each cascade follows the camera in steps of this fraction of its
+    /// radius, so the cached static layer survives small camera moves.
+    void SetShadowRecenterFraction(float f) { recenterFraction = f; }
+    /// Shadow filtering quality: number of Poisson PCF taps per fragment.
+    /// Each tap is a hardware 2x2 bilinear comparison.
+    enum ShadowQuality { ShadowHard = 1, ShadowLow = 4, ShadowMedium = 9, ShadowHigh = 16 };
+    void SetShadowQuality(ShadowQuality q) { shadowTaps = q; }
+    /// Force a full re-render of the static shadow layer next frame.
+    void InvalidateShadowCache() { staticValid = false; }
 
     glm::vec3 GetDirection() const { return direction; }
     glm::vec3 GetColor() const { return color; }
     glm::vec3 GetAmbient() const { return ambient; }
     bool IsShadowEnabled() const { return enableShadows; }
+    ShadowQuality GetShadowQuality() const { return shadowTaps; }
+    /// PCF tap count of the lit shaders (selects their ShaderFeatures tier).
+    int GetShadowFilterTaps() const { return (int)shadowTaps; }
 
+    /// GL_TEXTURE_2D_ARRAY depth texture, one layer per cascade, with
+    /// GL_TEXTURE_COMPARE_MODE set (sample it through sampler2DArrayShadow).
     GLuint GetDepthTexture() const { return depthTexture; }
 
-    glm::mat4 GetLightView() const { return lightView; }
-    glm::mat4 GetLightProj() const { return lightProj; }
-    glm::mat4 GetLightVP() const { return lightProj * lightView; }
+    int GetCascadeCount() const { return cascadeCount; }
+    glm::mat4 GetCascadeVP(int i) const { return cascadeProj[i] * cascadeView[i]; }
+    /// View-space distance at which cascade i ends.
+    float GetCascadeSplit(int i) const { return cascadeSplits[i]; }
+
+    /// Nearest cascade's matrices.
+    glm::mat4 GetLightView() const { return cascadeView[0]; }
+    glm::mat4 GetLightProj() const { return cascadeProj[0]; }
+    glm::mat4 GetLightVP() const { return GetCascadeVP(0); }
 
+    /// Shadow pass, per cascade.  Each cascade layer is built from two
+    /// layers: a cached static layer (voxel chunks + objects marked static)
+    /// that is only re-rendered when the cascade's matrices move or chunks
+    /// inside it are rebuilt (and then only their region), and a dynamic
+    /// layer (other models) drawn over a copy of it when something dynamic
+    /// is in range.
     void RenderShadowMap(Scene* scene);
 
+    /// Cumulative counters for the shadow cache (summed over cascades).
+    struct ShadowStats {
+        int staticFullRenders = 0;    // whole static cascade layer redrawn
+        int staticPatchRenders = 0;   // scissored region redraws
+        int dynamicRenders = 0;       // cascade layers that composed dynamic casters
+        int skippedFrames = 0;        // frames where nothing was drawn at all
+        int casterDraws = 0;          // caster instances drawn (per layer/patch)
+        int castersCulled = 0;        // models outside every cascade's light volume
+    };
+    const ShadowStats& GetShadowStats() const { return shadowStats; }
+
     static LightComponent* FindActive(Scene* scene);
 
+    /// Add the shadow depth program to ResourceManager's shader registry.
+    static void RegisterShaders();
+
 private:
+    struct Caster {
+        Object* object;
+        Model3DComponent* model;
+        glm::vec3 boundsMin;          // cached world-space AABB
+        glm::vec3 boundsMax;
+        unsigned cascadeMask;         // bit c: inside cascade c's light volume
+    };
+
     void ensureShadowResources();
+    void createDepthTarget(GLuint& fbo, GLuint& texture);
+    void releaseShadowResources();
     void computeLightMatrices(Scene* scene);
+    void gatherCasters(Scene* scene);
+    bool renderStaticPatches(int cascade, const glm::mat4& lightVP);
+    void drawStaticCasters(int cascade, const glm::mat4& lightVP, const Frustum& frustum, bool patch);
+    void drawCasters(const std::vector<Caster>& casters, int cascade, const Frustum* patch);
 
 private:
     glm::vec3 direction;
@@ -49,10 +116,34 @@ private:
     GLuint depthFBO;
     GLuint depthTexture;
 
-    glm::mat4 lightView;
-    glm::mat4 lightProj;
+    // Cascades
+    int cascadeCount = 3;
+    float splitLambda = 0.75f;
+    float shadowDistance = 50.0f;
+    float recenterFraction = 0.125f;
+    ShadowQuality shadowTaps = ShadowMedium;
+    glm::mat4 cascadeView[kMaxCascades];
+    glm::mat4 cascadeProj[kMaxCascades];
+    float cascadeSplits[kMaxCascades] = {};
+
+    // Layout the textures were allocated with
+    int allocatedCascades = 0;
+    int allocatedWidth = 0;
+    int allocatedHeight = 0;
+
+    // Static shadow layer cache
+    GLuint staticFBO = 0;
+    GLuint staticDepthTexture = 0;
+    bool staticValid = false;
+    glm::mat4 staticLightVP[kMaxCascades];
+    size_t staticCasterHash[kMaxCascades] = {};   // static casters each layer was drawn with
+    bool hadDynamicCasters[kMaxCascades] = {};
+
+    std::vector<Caster> staticCasters;   // per-frame scratch
+    std::vector<Caster> dynamicCasters;
+    std::vector<IVoxelRenderer::Bounds> changedBounds;
+    ShadowStats shadowStats;
 
-    // Camera-centered shadow frustum data
-    glm::vec3 shadowCenter = glm::vec3(0.0f);
-    float shadowRangeSq = 625.0f;
+    static constexpr int kMaxShadowPatches = 8;
+    static constexpr float kCasterDepth = 64.0f; // extra reach towards the light for tall casters
 };
@@ -16,7 +16,7 @@ public:
     virtual void Init() override;
 
     // Interpret Object::size as scale factors relative to imported dimensions
-    void SetSizeIsRelative(bool enabled) { sizeIsRelative = enabled; }
+    void SetSizeIsRelative(bool enabled) { sizeIsRelative = enabled; worldCacheValid = false; }
     bool GetSizeIsRelative() const { return sizeIsRelative; }
 
     // Added: expose model import-space AABB and computed dimensions
@@ -27,10 +27,45 @@ public:
 
     // Helpers for lighting/shadows
     glm::mat4 ComputeModelMatrix() const;
+
+    /// Cached ComputeModelMatrix(), rebuilt only when the owning object's
+    /// world transform or size changed since the last call.
+    const glm::mat4& GetWorldMatrix() const;
+    /// Model matrix to draw with: GetWorldMatrix(), or the same built from
+    /// the object's interpolated transform while it moves between ticks.
+    glm::mat4 GetRenderMatrix() const;
+    /// GetRenderMatrix() and its normal matrix (inverse transpose of the
+    /// upper 3x3); both come from the world cache when not interpolating.
+    void GetRenderTransform(glm::mat4& model, glm::mat3& normalMatrix) const;
+    /// World-space AABB of the model (cached alongside the world matrix).
+    void GetWorldBounds(glm::vec3& mn, glm::vec3& mx) const;
     void RenderDepthPass(const glm::mat4& model, GLuint depthProgram) const;
 
-    /// Called by RenderSystem — renders the model with the given camera and light.
-    void Render(const glm::mat4& view, const glm::mat4& projection, class LightComponent* light);
+    /// Renders this model alone.  Camera and light parameters come from the
+    /// per-frame FrameData block (see FrameUniforms); `light` supplies the
+    /// shadow map.  RenderSystem draws through ModelBatch instead, which
+    /// instances shared meshes.
+    void Render(class LightComponent* light);
+
+    // Batching keys and per-instance data
+    const SharedMeshData* GetSharedMesh() const { return sharedMesh; }
+    GLuint GetAlbedoOverride() const { return overrideAlbedoTexture; }
+    const glm::vec4& GetHighlightTint() const { return highlightTint; }
+
+    /// Lit "model3d" variant for a ShaderFeatures mask.  With Instanced it
+    /// reads the model matrix (locations 3-6), highlight tint (location 7)
+    /// and normal matrix (locations 8-10) per instance.
+    static GLuint GetLitProgram(uint32_t features);
+    /// Add the lit variants to ResourceManager's shader registry.
+    static void RegisterShaders();
+    /// Shadow map to bind for `light`: its depth texture, or a 1x1 dummy
+    /// so the sampler is never unbound.  Resolve on the main thread.
+    static GLuint GetShadowTexture(class LightComponent* light);
+    /// Bind the shadow map and sampler units for a bound lit program
+    /// (inside a recorded command).
+    static void BindLighting(GLuint program, GLuint shadowTexture);
+    /// Bind a sub-mesh's albedo (or the override) to texture unit 0.
+    static void BindAlbedo(const SharedMeshEntry& mesh, GLuint overrideTexture);
 
     // Override albedo/diffuse texture from code
     void SetAlbedoTexture(GLuint textureId) { overrideAlbedoTexture = textureId; }
@@ -61,4 +96,14 @@ private:
 
     // Highlight/tint overlay (rgb = color, a = mix factor)
     glm::vec4 highlightTint = glm::vec4(0.0f);
+
+    // World transform cache, keyed on the object's world version
+    glm::mat4 computeLocalMatrix() const;
+    void updateWorldCache() const;
+    mutable bool worldCacheValid = false;
+    mutable uint32_t cachedWorldVersion = 0;
+    mutable glm::mat4 worldMatrix = glm::mat4(1.0f);
+    mutable glm::mat3 worldNormalMatrix = glm::mat3(1.0f);
+    mutable glm::vec3 worldMin = glm::vec3(0.0f);
+    mutable glm::vec3 worldMax = glm::vec3(0.0f);
 };
@@ -0,0 +1,88 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+struct SharedMeshData;
+class Model3DComponent;
+class LightComponent;
+
+/// Instanced drawing of Model3DComponents that share a mesh.
+///
+/// Models queued with Add() are grouped by (shared mesh, albedo override).
+/// Each group streams its per-instance model matrices, normal matrices and
+/// highlight tints into one instance buffer and draws every sub-mesh with a
+/// single glDrawElementsInstanced.  Used by both the colour and the shadow
+/// pass.  The colour pass draws with the lit variant for the light, and
+/// groups holding a highlighted model with its Highlight variant.
+class ModelBatch {
+public:
+    static ModelBatch& Get();
+
+    /// Add the instanced depth program to ResourceManager's shader registry.
+    static void RegisterShaders();
+
+    /// Queue a model for the next flush (ignored if its mesh isn't loaded).
+    void Add(const Model3DComponent* model);
+    bool Empty() const { return m_active.empty(); }
+
+    /// Draw the queued models with the lit instanced variants and clear the
+    /// queue.  Camera and light data come from the FrameData block.
+    void FlushColor(LightComponent* light);
+    /// Draw the queued models into the bound depth target and clear the queue.
+    /// Leaves the instanced depth program bound.
+    void FlushDepth(const glm::mat4& lightVP);
+
+    /// Delete GL objects.  Call before the GL context is destroyed.
+    void Release();
+
+    struct Stats {
+        int groups = 0;       // instanced groups drawn
+        int instances = 0;    // models drawn
+        int drawCalls = 0;    // glDrawElementsInstanced calls (one per sub-mesh per group)
+    };
+    const Stats& GetStats() const { return m_stats; }
+    void ResetStats() { m_stats = Stats(); }
+
+private:
+    ModelBatch() = default;
+
+    struct Instance {
+        glm::mat4 model;
+        glm::vec4 tint;
+        glm::mat3 normal;
+    };
+    struct GroupKey {
+        const SharedMeshData* mesh;
+        GLuint albedo;
+        bool operator==(const GroupKey& o) const { return mesh == o.mesh && albedo == o.albedo; }
+    };
+    struct GroupKeyHash {
+        size_t operator()(const GroupKey& k) const {
+            return std::hash<const void*>()(k.mesh) ^ (std::hash<unsigned int>()(k.albedo) * 31u);
+        }
+    };
+    struct Group {
+        GroupKey key;
+        std::vector<Instance> instances;   // moved into the recorded draw per flush
+        bool highlighted = false;          // an instance has a visible tint
+    };
+    /// Colour pass state; the depth pass binds its program itself.
+    struct LitPass {
+        GLuint program;              // lit variant for the light
+        GLuint highlightProgram;     // same with Highlight (0 if unused)
+        GLuint shadowTexture;
+    };
+
+    void drawGroups(const LitPass* lit);
+    void configureVAO(GLuint vao, GLuint instanceVBO);
+
+    std::unordered_map<GroupKey, int, GroupKeyHash> m_groupIndex;
+    std::vector<Group> m_groups;
+    std::vector<int> m_active;             // groups with queued instances, in first-use order
+    std::unordered_set<GLuint> m_configuredVAOs;   // touched by recorded commands only
+    GLuint m_instanceVBO = 0;
+    Stats m_stats;
+};
@@ -0,0 +1,105 @@
+#pragma once
+// ---------------------------------------------------------------------------
+//  PoolAllocator — STL allocator backed by per-size free lists.
+//
+//  Single-object allocations (shared_ptr control blocks made with
+//  std::allocate_shared, unordered_map nodes, ...) are served from a free
+//  list of fixed-size blocks and returned to it on release, so containers
+//  that churn through the same kinds of objects stop hitting the heap once
+//  they reach a steady state.  Array allocations fall through to
+//  ::operator new.
+//
+//  Blocks may be released from any thread (e.g. when a background reader
+//  drops the last reference to a shared object).  The pools are never
+//  destroyed so late releases during shutdown stay valid.
+//
+//  Usage:
+//      auto p = std::allocate_shared<Foo>(PoolAllocator<Foo>());
+//      GetPoolAllocatorStats()   // heap vs recycled allocation counters
+// ---------------------------------------------------------------------------
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+struct PoolAllocatorStats {
+    std::atomic<size_t> heapAllocations{0};   // blocks that had to come from ::operator new
+    std::atomic<size_t> reusedAllocations{0}; // blocks recycled from a free list
+};
+
+inline PoolAllocatorStats& GetPoolAllocatorStats() {
+    static PoolAllocatorStats stats;
+    return stats;
+}
+
+/// Free list of blocks of exactly `Size` bytes.
+template <size_t Size>
+class FixedBlockPool {
+public:
+    static FixedBlockPool& Get() {
+        static FixedBlockPool* pool = new FixedBlockPool(); // intentionally leaked
+        return *pool;
+    }
+
+    void* Allocate() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_free) {
+                FreeBlock* b = m_free;
+                m_free = b->next;
+                GetPoolAllocatorStats().reusedAllocations++;
+                return b;
+            }
+        }
+        GetPoolAllocatorStats().heapAllocations++;
+        return ::operator new(kBlockSize);
+    }
+
+    void Release(void* p) {
+        if (!p) return;
+        FreeBlock* b = static_cast<FreeBlock*>(p);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        b->next = m_free;
+        m_free = b;
+    }
+
+private:
+    struct FreeBlock { FreeBlock* next; };
+    static constexpr size_t kBlockSize = Size < sizeof(FreeBlock) ? sizeof(FreeBlock) : Size;
+
+    FixedBlockPool() = default;
+
+    std::mutex m_mutex;
+    FreeBlock* m_free = nullptr;
+};
+
+template <typename T>
+struct PoolAllocator {
+    using value_type = T;
+
+    PoolAllocator() noexcept = default;
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        if (n != 1) {
+            GetPoolAllocatorStats().heapAllocations++;
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+        return static_cast<T*>(FixedBlockPool<sizeof(T)>::Get().Allocate());
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if (n != 1) {
+            ::operator delete(p);
+            return;
+        }
+        FixedBlockPool<sizeof(T)>::Get().Release(p);
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const PoolAllocator<U>&) const noexcept { return false; }
+};
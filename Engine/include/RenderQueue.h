@@ -0,0 +1,88 @@
+#pragma once
+// ---------------------------------------------------------------------------
+//  RenderQueue — per-frame list of draw packets ordered by a 64-bit sort key.
+//
+//  Key layout (most significant bits first):
+//
+//      3D:  pass:2 | shader:8 | texture:16 | mesh:16 | depth:22
+//      2D:  pass:2 | layer:16 | (unused):24 | sequence:22
+//
+//  3D packets are state-sorted (program, then texture, then mesh) and
+//  front-to-back within equal state, for early-z.  2D packets are blended,
+//  so they keep submission order inside a layer: sorting them by texture
+//  would draw overlapping sprites in the wrong order.  SpriteBatch still
+//  merges consecutive quads that share a texture into one draw.
+//
+//  Usage:
+//      queue.Clear();
+//      queue.Submit(packet);   // for every visible component
+//      queue.Sort();
+//      for (const auto& p : queue.Packets()) { ... }
+// ---------------------------------------------------------------------------
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class Component;
+
+class RenderQueue {
+public:
+    /// Passes run in this order.  2D elements below every 3D model are a
+    /// background, the rest are drawn over the 3D scene.
+    enum Pass { PassBackground = 0, PassOpaque = 1, PassOverlay = 2 };
+    /// Program slots, in the order the passes prefer to bind them.
+    /// Text shares the sprite program (glyph quads go through SpriteBatch).
+    enum ShaderSlot { ShaderModel = 1, ShaderSprite = 2 };
+    enum Kind : uint8_t { KindModel, KindImage, KindText };
+
+    struct Packet {
+        uint64_t key;
+        Component* component;
+        Kind kind;
+        // GL state the draw needs, for the transition counters
+        uint32_t program;
+        uint32_t texture;
+        uint32_t vao;
+    };
+
+    /// 3D packet key.  `depth01` is the normalised view distance (0 = near).
+    static uint64_t OpaqueKey(uint32_t shader, uint32_t texture, uint32_t mesh, float depth01);
+    /// 2D packet key.  `sequence` is the submission index within the frame.
+    static uint64_t OverlayKey(Pass pass, int layer, uint32_t sequence);
+
+    /// Pass and layer bits of a 2D key (equal for packets in the same layer).
+    static uint64_t OverlayGroup(uint64_t key) { return key >> 46; }
+
+    /// Stable 16-bit id for a mesh pointer, used in OpaqueKey.
+    uint32_t MeshId(const void* mesh);
+
+    void Clear() { m_packets.clear(); }
+    void Submit(const Packet& packet) { m_packets.push_back(packet); }
+    uint32_t Size() const { return (uint32_t)m_packets.size(); }
+
+    /// LSD radix sort on the key (stable), then update the counters.
+    void Sort();
+    const std::vector<Packet>& Packets() const { return m_packets; }
+
+    /// How often program, texture and VAO differ between consecutive
+    /// packets in sorted order: a measure of how well the keys group state.
+    /// These are not GL state changes.  ModelBatch instancing and SpriteBatch
+    /// merging collapse many packets into one draw, and GLState skips
+    /// redundant binds, so GLState::GetIssued() reports what reaches GL.
+    struct Stats {
+        int packets = 0;
+        int programTransitions = 0;
+        int textureTransitions = 0;
+        int vaoTransitions = 0;
+    };
+    const Stats& GetStats() const { return m_stats; }
+
+private:
+    void countTransitions();
+
+    std::vector<Packet> m_packets;
+    std::vector<Packet> m_scratch;          // radix sort ping-pong buffer
+    std::unordered_map<const void*, uint32_t> m_meshIds;
+    Stats m_stats;
+};
@@ -1,4 +1,5 @@
 #pragma once
+#include "RenderQueue.h"
 
 class Scene;
 
@@ -8,8 +9,9 @@ class Scene;
 /// Responsibilities:
 ///   1. Find the active camera and light in the scene
 ///   2. Execute the shadow pass (via LightComponent)
-///   3. Render all 3D models (Model3DComponent)
-///   4. Render all 2D overlays (Image/Sprite, TextComponent)
+///   3. Queue visible models and 2D elements as sort-keyed packets
+///      (see RenderQueue) and submit them in key order: 2D background,
+///      state-sorted 3D models, then 2D overlays in layer order
 ///
 /// This replaces the old approach where each component rendered itself
 /// inside its own LateUpdate, duplicating camera/light lookup logic.
@@ -17,4 +19,10 @@ class RenderSystem {
 public:
     /// Render the entire scene: shadows → 3D → 2D overlay.
     static void Render(Scene* scene);
+
+    /// Packet count and state switches of the last frame's queue.
+    static const RenderQueue::Stats& GetQueueStats() { return s_queue.GetStats(); }
+
+private:
+    static RenderQueue s_queue;
 };
@@ -0,0 +1,146 @@
+#pragma once
+// ---------------------------------------------------------------------------
+//  RenderThread — replays recorded frames on a thread that owns the GL context.
+//
+//  RenderSystem and the batches it drives no longer call GL directly while
+//  walking the scene: they resolve everything a draw needs (matrices,
+//  instance data, vertices, GL object names) on the main thread and record
+//  a command that owns copies of it.  SubmitFrame() hands the frame to the
+//  render thread, which executes it while the main thread simulates the
+//  next one.
+//
+//      RecordGL([prog, mvp] { glUseProgram(prog); ... });   // main thread
+//      RenderThread::Get().SubmitFrame();                   // end of frame
+//
+//  Resources are created without leaving the recording: AllocateName()
+//  hands out a GL name from a pool the render thread keeps filled, and the
+//  upload is recorded like any other command, so draws recorded after it
+//  can use the name.
+//
+//      GLuint vbo = RenderThread::Get().AllocateName(RenderThread::NameBuffer);
+//      RecordGL([vbo, data = std::move(data)] { ... glBufferData(...); });
+//
+//  Other GL work outside recorded commands (shader builds, render target
+//  setup, shutdown) must hold a GLContextLock: it waits until the render
+//  thread has executed every submitted frame and borrows the context.
+//
+//  Synchronous mode (for debugging) records the same commands but executes
+//  them on the main thread at SubmitFrame().  Before Start() and after
+//  Stop(), commands execute as soon as they are recorded.
+//
+//  The null backend (headless runs without a GL context) records and counts
+//  commands as usual but never executes them; code that calls GL outside a
+//  recorded command checks IsNullBackend() and skips it.
+// ---------------------------------------------------------------------------
+
+#include <GL/glew.h>
+#include <SDL.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// One frame of recorded GL work, executed in recording order.
+class RenderCommandBuffer {
+public:
+    using Command = std::function<void()>;
+
+    void Record(Command command) { m_commands.push_back(std::move(command)); }
+    void Execute();
+    void Clear() { m_commands.clear(); }
+    size_t Size() const { return m_commands.size(); }
+
+private:
+    std::vector<Command> m_commands;
+};
+
+class RenderThread {
+public:
+    static RenderThread& Get();
+
+    /// Begin buffering frames.  `threaded` moves the context to a render
+    /// thread; at most `maxQueuedFrames` frames wait for it (the one being
+    /// executed not included) before SubmitFrame() blocks.
+    void Start(SDL_Window* window, SDL_GLContext context, bool threaded, int maxQueuedFrames = 1);
+    /// Execute every submitted frame, join the thread and make the context
+    /// current on the calling thread again.
+    void Stop();
+
+    bool IsThreaded() const { return m_threaded; }
+
+    /// Drop recorded commands instead of executing them.  Set before
+    /// anything records; implies synchronous mode.
+    void SetNullBackend(bool enabled) { m_null = enabled; }
+    bool IsNullBackend() const { return m_null; }
+
+    /// Append a command to the frame being recorded (main thread).
+    void Record(RenderCommandBuffer::Command command);
+    /// Close the frame being recorded and queue it for execution.
+    void SubmitFrame();
+    /// Block until every submitted frame has been executed.
+    void Finish();
+
+    enum NameKind { NameBuffer, NameVertexArray, NameTexture, NameKindCount };
+    /// A fresh GL name for a resource created on the main thread; the
+    /// recorded command that first binds it creates the object.  The pool
+    /// is refilled on the GL thread after each frame, so this only waits
+    /// for queued frames (through a GLContextLock) when it runs dry.
+    /// 0 under the null backend.
+    GLuint AllocateName(NameKind kind);
+
+    struct Stats {
+        int commands = 0;        // commands in the last submitted frame
+        float submitWaitMs = 0;  // main thread blocked on a full queue, last frame
+    };
+    const Stats& GetStats() const { return m_stats; }
+
+private:
+    friend class GLContextLock;
+    RenderThread() = default;
+    void run();
+    void refillNames();    // GL thread, context current
+    void releaseNames();
+
+    SDL_Window* m_window = nullptr;
+    SDL_GLContext m_context = nullptr;
+    bool m_started = false;
+    bool m_threaded = false;
+    bool m_null = false;
+    int m_maxQueuedFrames = 1;
+
+    RenderCommandBuffer m_recording;
+    std::deque<RenderCommandBuffer> m_queue;
+    bool m_executing = false;
+    bool m_running = false;
+    std::mutex m_queueMutex;
+    std::condition_variable m_queueChanged;
+    std::mutex m_contextMutex;              // held by whichever thread has the context current
+    std::thread m_thread;
+    Stats m_stats;
+
+    std::mutex m_namesMutex;
+    std::vector<GLuint> m_names[NameKindCount];   // generated, not yet handed out
+};
+
+/// Record a GL command for the current frame.
+inline void RecordGL(RenderCommandBuffer::Command command)
+{
+    RenderThread::Get().Record(std::move(command));
+}
+
+/// Scoped GL access for resource work on the main thread.  Drains the
+/// render thread and makes the context current here.  Nests, and is a no-op
+/// inside recorded commands or when rendering is synchronous.
+class GLContextLock {
+public:
+    GLContextLock();
+    ~GLContextLock();
+    GLContextLock(const GLContextLock&) = delete;
+    GLContextLock& operator=(const GLContextLock&) = delete;
+
+private:
+    bool m_outermost = false;   // not nested in another lock or a recorded command
+    bool m_acquired = false;    // took the context from the render thread
+};
@@ -1,9 +1,11 @@
 #ifndef RESOURCE_MANAGER_H
 #define RESOURCE_MANAGER_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <utility>
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 
@@ -28,6 +30,49 @@ struct SharedMeshData {
     glm::vec3 aabbMax = glm::vec3(-1e9f);
 };
 
+// ---------------------------------------------------------------------------
+// Shared sprite textures — decoded once per distinct image and referenced by
+// every Sprite that shows it.  Entries are keyed by a hash of the encoded
+// bytes, so two copies of the same PNG read from an archive resolve to the
+// same GL texture without decoding the second one.
+// ---------------------------------------------------------------------------
+struct SharedTexture {
+    GLuint id   = 0;        // 0 under the null backend
+    int width   = 0;
+    int height  = 0;
+    uint64_t hash = 0;
+    int refs    = 0;
+    bool valid  = false;    // decoded and (with a GPU) uploaded
+};
+
+/// Refcounted reference to a SharedTexture.  Copies add a reference; the GL
+/// texture is deleted when the last handle is destroyed.  Copying is cheap,
+/// so swapping the image a Sprite shows is just a handle assignment.
+class TextureHandle {
+public:
+    TextureHandle() = default;
+    TextureHandle(const TextureHandle& o) : m_tex(o.m_tex) { if (m_tex) m_tex->refs++; }
+    TextureHandle(TextureHandle&& o) noexcept : m_tex(o.m_tex) { o.m_tex = nullptr; }
+    TextureHandle& operator=(TextureHandle o) noexcept { std::swap(m_tex, o.m_tex); return *this; }
+    ~TextureHandle() { Reset(); }
+
+    /// Drop this reference (the handle becomes empty).
+    void Reset();
+
+    GLuint GetID() const  { return m_tex ? m_tex->id : 0; }
+    int GetWidth() const  { return m_tex ? m_tex->width : 0; }
+    int GetHeight() const { return m_tex ? m_tex->height : 0; }
+    explicit operator bool() const { return m_tex && m_tex->valid; }
+    bool operator==(const TextureHandle& o) const { return m_tex == o.m_tex; }
+    bool operator!=(const TextureHandle& o) const { return m_tex != o.m_tex; }
+
+private:
+    friend class ResourceManager;
+    explicit TextureHandle(SharedTexture* tex) : m_tex(tex) { if (m_tex) m_tex->refs++; }
+
+    SharedTexture* m_tex = nullptr;
+};
+
 /// ResourceManager — central cache for GPU resources (textures + shaders).
 ///
 /// All resources are indexed by a string key:
@@ -45,8 +90,6 @@ public:
     ResourceManager(const ResourceManager&) = delete;
     ResourceManager& operator=(const ResourceManager&) = delete;
 
-    // ── Textures ─────────────────────────────────────────────────────────────
-
     // ── Meshes ───────────────────────────────────────────────────────────────
 
     /// Load a 3-D model from a file path.  Returns shared (cached) geometry so
@@ -64,28 +107,107 @@ public:
     GLuint LoadTextureFromMemory(const std::string& key,
                                   const std::vector<unsigned char>& data);
 
-    // ── Shaders ──────────────────────────────────────────────────────────────
+    /// Shared sprite texture for in-memory image bytes, keyed by their content
+    /// hash: repeated calls with the same image return the same texture
+    /// without decoding it again.  Returns an empty handle on failure.
+    TextureHandle AcquireTexture(const std::vector<unsigned char>& data);
+
+    /// Number of live shared sprite textures (one per distinct image).
+    size_t GetSharedTextureCount() const { return m_sharedTextures.size(); }
 
-    /// Return a compiled + linked shader program by name.
-    /// If not yet compiled, builds it from the provided GLSL sources.
+    // ── Shaders ──────────────────────────────────────────────────────────────
+    //
+    // Programs are registered by name with their sources, built during the
+    // loading phase (PrecompileShaders) and fetched by name afterwards.
+    // Linked programs are saved with glGetProgramBinary and reloaded on the
+    // next run when the sources and the driver are unchanged, so startup
+    // skips compiling them.
+
+    /// Add a program to the registry (a name already registered keeps its
+    /// first sources).  Nothing is compiled yet.
+    void RegisterShader(const std::string& name, const char* vertSrc, const char* fragSrc);
+
+    /// Build every registered program that isn't built yet, from the binary
+    /// cache where possible.  Call while loading, not mid-frame.
+    void PrecompileShaders();
+
+    /// A registered program by name, built now if PrecompileShaders hasn't
+    /// run.  Returns 0 for an unknown name.
+    GLuint GetShader(const std::string& name);
+
+    /// Register (if new) and return a shader program by name.
     GLuint GetOrCreateShader(const std::string& name,
                               const char* vertSrc,
                               const char* fragSrc);
 
+    /// Register a family of programs built from one pair of sources.  A
+    /// variant is picked by a feature mask: bit i inserts
+    /// "#define <featureDefines[i]>" after the #version line of both stages.
+    void RegisterShaderVariants(const std::string& name, const char* vertSrc, const char* fragSrc,
+                                std::vector<std::string> featureDefines);
+
+    /// The variant of `name` for `features`, compiled (or loaded from the
+    /// binary cache) on first use and cached by mask.  0 for an unknown name.
+    GLuint GetShaderVariant(const std::string& name, uint32_t features);
+
+    /// Have PrecompileShaders build a variant that is likely to be used,
+    /// so its first use doesn't compile mid-frame.
+    void PreloadShaderVariant(const std::string& name, uint32_t features);
+
+    /// Directory for cached program binaries ("shader_cache" by default;
+    /// empty disables the cache).
+    void SetShaderCacheDirectory(const std::string& directory) { m_shaderCacheDir = directory; }
+
+    struct ShaderStats {
+        int compiled = 0;       // built from source
+        int fromBinary = 0;     // loaded from the binary cache
+    };
+    const ShaderStats& GetShaderStats() const { return m_shaderStats; }
+
     // ── Lifecycle ────────────────────────────────────────────────────────────
 
+    /// Record the deletion of shared textures released during this frame.
+    /// Call once per frame after the last draw is recorded: quads queued in
+    /// a batch may still name a texture whose last handle is already gone.
+    void EndFrame();
+
     /// Delete all cached GL objects.  Call before the GL context is destroyed.
     void ReleaseAll();
 
 private:
     ResourceManager() = default;
 
-    GLuint uploadSurface(SDL_Surface* surface);
-    static GLuint compileProgram(const char* vertSrc, const char* fragSrc);
+    friend class TextureHandle;
+
+    GLuint uploadSurface(SDL_Surface* surface, bool sprite = false);
+    void releaseTexture(SharedTexture* tex);
+    struct ShaderSource {
+        std::string vertex;
+        std::string fragment;
+    };
+    struct ShaderVariants {
+        ShaderSource base;
+        std::vector<std::string> defines;               // one per feature bit
+        std::unordered_map<uint32_t, GLuint> programs;  // built variants, by mask
+    };
+    std::string registerVariant(const std::string& name, ShaderVariants& set, uint32_t features);
+    GLuint buildProgram(const std::string& name, const ShaderSource& source);
+    static GLuint compileProgram(const char* vertSrc, const char* fragSrc, bool retrievable);
+    bool programBinariesSupported();
+    GLuint loadProgramBinary(const std::string& path, uint64_t key);
+    void saveProgramBinary(GLuint program, const std::string& path, uint64_t key);
 
     std::unordered_map<std::string, GLuint> m_textureCache;
     std::unordered_map<std::string, GLuint> m_shaderCache;
+    std::unordered_map<std::string, ShaderSource> m_shaderSources;   // the registry
+    std::unordered_map<std::string, ShaderVariants> m_shaderVariants;
+    std::string m_shaderCacheDir = "shader_cache";
+    std::string m_driverKey;                 // vendor / renderer / version, set on first use
+    int m_programBinaries = -1;              // -1 = not yet queried
+    ShaderStats m_shaderStats;
     std::unordered_map<std::string, SharedMeshData> m_meshCache;
+    std::unordered_map<uint64_t, SharedTexture> m_sharedTextures;   // by content hash
+    std::vector<GLuint> m_releasedTextures;  // deleted at EndFrame()
 };
 
 #endif // RESOURCE_MANAGER_H
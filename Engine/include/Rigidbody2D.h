@@ -14,7 +14,7 @@ public:
 
     void Init() override {}
 
-    void Update(float deltaTime) override {
+    void FixedUpdate(float deltaTime) override {
         if (!object) return;
 
         Vector2 frameAccel = acceleration;
@@ -9,7 +9,7 @@ public:
     Rigidbody3D() : velocity(0,0,0), acceleration(0,0,0), mass(1.0f), useGravity(true), gravity(-9.81f) {}
 
     void Init() override {}
-    void Update(float dt) override;
+    void FixedUpdate(float dt) override;
 
     void SetVelocity(const Vector3& v) { velocity = v; }
     void SetAcceleration(const Vector3& a) { acceleration = a; }
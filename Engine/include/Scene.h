@@ -8,6 +8,7 @@
 class Object;
 class Engine;
 class Sprite;
+class TextureHandle;
 
 class Scene {
 public:
@@ -21,12 +22,18 @@ public:
 
     void UpdateEvents(SDL_Event event);
     void UpdateScene(float deltaTime);
+    /// One simulation tick: FixedUpdate on every active, non-static object.
+    void FixedUpdateScene(float fixedDeltaTime);
+    /// Blend the transforms of the last two ticks for rendering; `alpha`
+    /// is the fraction of a tick elapsed since the last one (0..1).
+    void InterpolateTransforms(float alpha);
 
     Object* CreateObject();
     void DeleteObject(Object* object);
     void flushPendingDeletes();
 
     Sprite* createSprite(const std::vector<unsigned char>& imageData);
+    Sprite* createSprite(const TextureHandle& texture);
 
     void updateLayer();
 
@@ -50,6 +57,7 @@ public:
 private:
     /// Check every pair of BoxCollider3D owners and fire callbacks.
     void dispatchCollisions();
+    void updateTransforms();
 
 private: 
     std::vector<Object*> objects;
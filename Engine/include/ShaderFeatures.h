@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class LightComponent;
+
+/// Feature bits of the lit shader variants ("model3d", "chunk_mesh").
+///
+/// Each bit compiles one #define into the program (see
+/// ResourceManager::RegisterShaderVariants), so a variant contains only the
+/// code it uses instead of branching on uniforms.  Callers build the mask
+/// for what they draw and fetch the matching program.
+class ShaderFeatures {
+public:
+    enum : uint32_t {
+        Instanced   = 1u << 0,   // model matrix, normal matrix and tint per instance
+        Shadows     = 1u << 1,   // sample the cascaded shadow map
+        ShadowPcf4  = 1u << 2,   // PCF tier; with none set, one hardware tap
+        ShadowPcf9  = 1u << 3,
+        ShadowPcf16 = 1u << 4,
+        Highlight   = 1u << 5,   // apply the highlight tint / block outline
+    };
+
+    /// The #define of each bit, in bit order.
+    static const std::vector<std::string>& Defines();
+
+    /// Shadows plus the PCF tier of `light`, or 0 if it casts no shadow map
+    /// this frame.  Matches what FrameUniforms uploads for the light.
+    static uint32_t ForLight(const LightComponent* light);
+};
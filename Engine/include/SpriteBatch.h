@@ -0,0 +1,89 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <mutex>
+#include <vector>
+
+/// Batched 2D quad renderer.
+///
+/// Draw() transforms a quad on the CPU and appends it to a streaming vertex
+/// buffer; the pending quads are drawn with one call when the texture
+/// changes, the buffer fills up, or Flush() is called (RenderSystem flushes
+/// at the end of each 2D layer and before any non-sprite draw), so layer
+/// order is preserved.  A change of Style flushes as well.
+class SpriteBatch {
+public:
+    static SpriteBatch& Get();
+
+    /// Add the batch programs to ResourceManager's shader registry.
+    static void RegisterShaders();
+
+    /// How the texture of a batch is interpreted.
+    struct Style {
+        /// Texture alpha is a signed distance (0.5 on the edge), as in a
+        /// distance-field font atlas; edges stay sharp at any scale.
+        bool distanceField = false;
+        /// Outline thickness in distance units (0 .. 0.5), distance field only.
+        float outlineWidth = 0.0f;
+        glm::vec4 outlineColor = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+
+        bool operator==(const Style& o) const {
+            return distanceField == o.distanceField && outlineWidth == o.outlineWidth &&
+                   outlineColor == o.outlineColor;
+        }
+        bool operator!=(const Style& o) const { return !(*this == o); }
+    };
+
+    /// Queue a quad in window pixels (origin top-left, like Sprite).
+    /// `angle` is in degrees around the quad centre; `uvRect` is (u0, v0, u1, v1).
+    void Draw(GLuint texture, const glm::vec2& position, const glm::vec2& size, float angle,
+              const glm::vec4& color, const glm::vec4& uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f));
+    /// Same, with an explicit style (e.g. distance-field glyphs).
+    void Draw(GLuint texture, const glm::vec2& position, const glm::vec2& size, float angle,
+              const glm::vec4& color, const glm::vec4& uvRect, const Style& style);
+
+    /// Draw every pending quad.
+    void Flush();
+
+    /// True when nothing is waiting to be flushed.
+    bool Empty() const { return m_vertices.empty(); }
+
+    /// Delete GL objects.  Call before the GL context is destroyed.
+    void Release();
+
+    /// VAO every batched draw uses (0 until the first flush).
+    GLuint GetVAO() const { return m_vao; }
+
+    struct Stats {
+        int quads = 0;
+        int drawCalls = 0;
+    };
+    const Stats& GetStats() const { return m_stats; }
+    void ResetStats() { m_stats = Stats(); }
+
+    static constexpr int kMaxQuads = 4096;   // 16-bit indices: 4 vertices per quad
+
+private:
+    SpriteBatch() = default;
+    void init();
+
+    struct Vertex {
+        float x, y;
+        float u, v;
+        float r, g, b, a;
+    };
+
+    // Vertex arrays go to the recorded draws and come back once executed,
+    // so batches reuse their capacity instead of allocating on every flush.
+    std::vector<Vertex> takeVertexArray();
+    void returnVertexArray(std::vector<Vertex>&& vertices);
+    static constexpr size_t kMaxPooledArrays = 64;
+
+    std::vector<Vertex> m_vertices;
+    std::mutex m_poolMutex;                      // the render thread returns arrays
+    std::vector<std::vector<Vertex>> m_vertexPool;
+    GLuint m_texture = 0;
+    Style m_style;
+    GLuint m_vao = 0, m_vbo = 0, m_ebo = 0;
+    Stats m_stats;
+};
@@ -0,0 +1,46 @@
+#pragma once
+// ---------------------------------------------------------------------------
+//  VoxelMeshData / IChunkMeshSink — CPU-side chunk geometry and the interface
+//  a voxel world pushes it through.
+//
+//  Deliberately GL-free: the world simulation and mesher only talk to an
+//  IChunkMeshSink, so they can run headless (benchmarks, tools) with a sink
+//  that just inspects the data.  VoxelRenderer is the GPU-uploading sink.
+// ---------------------------------------------------------------------------
+
+#include <glm/glm.hpp>
+#include <vector>
+
+/// One texture's worth of chunk faces.
+/// Vertex layout: pos(3) + normal(3) + uv(2) = 8 floats.
+struct VoxelMeshData {
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+    unsigned int textureId = 0;
+};
+
+class IChunkMeshSink {
+public:
+    virtual ~IChunkMeshSink() = default;
+
+    /// A chunk's geometry is split into a body plus one border strip per
+    /// side (the faces that look across the chunk edge).  Border strips can
+    /// be replaced on their own when a neighbour chunk appears or changes.
+    enum ChunkPart {
+        PartBody = 0,
+        PartBorderNegX,
+        PartBorderPosX,
+        PartBorderNegZ,
+        PartBorderPosZ,
+        PartCount
+    };
+
+    /// Replace a chunk's body mesh and bounds (registers the chunk if new).
+    /// The mesh data is consumed: on return every vertex/index vector has
+    /// been emptied but keeps its capacity, so callers can recycle it.
+    virtual void UpdateChunk(int cx, int cz, const glm::vec3& aabbMin, const glm::vec3& aabbMax,
+                             std::vector<VoxelMeshData>& meshes) = 0;
+    /// Replace a single part of an already registered chunk (same contract).
+    virtual void UpdateChunkPart(int cx, int cz, int part, std::vector<VoxelMeshData>& meshes) = 0;
+    virtual void RemoveChunk(int cx, int cz) = 0;
+};
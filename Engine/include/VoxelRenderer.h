@@ -1,36 +1,51 @@
 #pragma once
 #include "IVoxelRenderer.h"
+#include "VoxelMeshData.h"
 #include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
 #include <vector>
 #include <unordered_map>
 
-struct VoxelMeshData {
-    std::vector<float> vertices;
-    std::vector<unsigned int> indices;
-    unsigned int textureId;
-};
-
-class VoxelRenderer : public IVoxelRenderer {
+/// GPU sink for chunk meshes: uploads them into VAOs and draws them.
+class VoxelRenderer : public IVoxelRenderer, public IChunkMeshSink {
 public:
     static VoxelRenderer& Get();
 
+    /// Add the chunk program variants to ResourceManager's shader registry.
+    static void RegisterShaders();
+
     void Init();
 
-    // Register a chunk to be rendered
-    void UpdateChunk(int cx, int cz, const glm::vec3& aabbMin, const glm::vec3& aabbMax, const std::vector<VoxelMeshData>& meshes);
-    void RemoveChunk(int cx, int cz);
+    // IChunkMeshSink
+    void UpdateChunk(int cx, int cz, const glm::vec3& aabbMin, const glm::vec3& aabbMax, std::vector<VoxelMeshData>& meshes) override;
+    void UpdateChunkPart(int cx, int cz, int part, std::vector<VoxelMeshData>& meshes) override;
+    void RemoveChunk(int cx, int cz) override;
     void Clear();
 
     void SetHighlight(const glm::vec3& pos, bool active, float blockHalfSize);
 
-    void RenderChunks(const glm::mat4& view, const glm::mat4& projection, LightComponent* light, const Frustum& frustum) override;
-    void RenderChunksDepth(unsigned int depthProgram, const glm::mat4& lightVP, const Frustum& lightFrustum) override;
+    void RenderChunks(LightComponent* light, const Frustum& frustum) override;
+    void RenderChunksDepth(unsigned int depthProgram, const glm::mat4& lightVP, const Frustum& lightFrustum, int cascade) override;
+    bool TakeChangedBounds(std::vector<Bounds>& out) override;
+
+    /// Each frustum that culls the chunks keeps its own coherence hints.
+    enum CullSlot { CullCamera = 0, CullShadow0, CullSlotCount = CullShadow0 + kMaxShadowCascades };
+
+    /// Nodes visited by the last cull of a slot (regions -> clusters -> chunks).
+    struct CullStats {
+        int regionsTested = 0;
+        int clustersTested = 0;
+        int chunksTested = 0;
+        int chunksVisible = 0;
+    };
+    const CullStats& GetCullStats(CullSlot slot) const { return m_cullStats[slot]; }
 
 private:
     VoxelRenderer() = default;
     ~VoxelRenderer();
 
-    unsigned int getOrCreateChunkShader();
+    unsigned int getChunkShader(uint32_t features);   // "chunk_mesh" variant (ShaderFeatures mask)
     unsigned int getDummyShadow();
 
     struct ChunkKey {
@@ -51,15 +66,63 @@ private:
         unsigned int textureId = 0;
     };
 
+    static_assert(CullSlotCount == 5, "update kNoRejectPlane");
+    static constexpr std::array<int, CullSlotCount> kNoRejectPlane{-1, -1, -1, -1, -1};
+
     struct ChunkRenderData {
         glm::vec3 aabbMin;
         glm::vec3 aabbMax;
-        std::vector<MeshGroup> meshGroups;
+        std::array<std::vector<MeshGroup>, PartCount> parts;
+        std::array<int, CullSlotCount> lastRejectPlane = kNoRejectPlane;
+
+        bool Empty() const {
+            for (const auto& p : parts) if (!p.empty()) return false;
+            return true;
+        }
     };
 
+    // ── Culling hierarchy ────────────────────────────────────────────────
+    // Chunks are grouped into 4x4 clusters, clusters into 4x4 regions
+    // (16x16 chunks).  Each node carries the union of its children's bounds
+    // so a rejected region or cluster skips all chunks below it, and a node
+    // fully inside the frustum draws its children without further tests.
+    static constexpr int kClusterShift = 2; // 4 chunks per cluster side
+    static constexpr int kRegionShift  = 2; // 4 clusters per region side
+
+    struct CullNode {
+        glm::vec3 aabbMin = glm::vec3(0.0f);
+        glm::vec3 aabbMax = glm::vec3(0.0f);
+        std::array<int, CullSlotCount> lastRejectPlane = kNoRejectPlane;
+    };
+    struct Cluster : CullNode {
+        std::vector<ChunkRenderData*> chunks; // unordered_map values never move
+    };
+    struct Region : CullNode {
+        std::vector<Cluster*> clusters;
+    };
+
+    void linkChunk(const ChunkKey& key, ChunkRenderData* chunk);
+    void unlinkChunk(const ChunkKey& key, ChunkRenderData* chunk);
+    void refitCluster(const ChunkKey& clusterKey);
+    void refitRegion(const ChunkKey& regionKey);
+
+    template <typename Fn>
+    void forEachVisibleChunk(const Frustum& frustum, CullSlot slot, Fn&& fn);
+
+    void uploadMeshGroups(std::vector<MeshGroup>& groups, std::vector<VoxelMeshData>& meshes);
+    void freeMeshGroups(std::vector<MeshGroup>& groups);
     void freeChunkMeshes(ChunkRenderData& chunk);
 
     std::unordered_map<ChunkKey, ChunkRenderData, ChunkKeyHash> m_chunks;
+    std::unordered_map<ChunkKey, Cluster, ChunkKeyHash> m_clusters;
+    std::unordered_map<ChunkKey, Region, ChunkKeyHash> m_regions;
+    std::array<CullStats, CullSlotCount> m_cullStats;
+
+    // Chunks whose geometry changed since the last TakeChangedBounds()
+    void markChanged(const ChunkKey& key, const glm::vec3& mn, const glm::vec3& mx);
+    std::unordered_map<ChunkKey, Bounds, ChunkKeyHash> m_changed;
+    bool m_changedAll = false; // too many to track individually (or nobody is taking them)
+    static constexpr size_t kMaxChangedChunks = 1024;
 
     bool m_highlightActive = false;
     glm::vec3 m_highlightPos = glm::vec3(0.0f);
@@ -17,6 +17,13 @@ public:
     virtual void Update(float deltaTime) {
     }
 
+    // Called at the engine's fixed tick rate, before this frame's Update().
+    // Put physics and other simulation here: the step is always the same,
+    // so results don't depend on the frame rate.  Objects moved here are
+    // drawn interpolated between ticks.
+    virtual void FixedUpdate(float fixedDeltaTime) {
+    }
+
     // Called after ALL objects have run Update().
     // Use for logic that depends on the final state of other objects
     // this frame (e.g. camera following). Rendering is handled by RenderSystem.
@@ -8,6 +8,13 @@ class ArchiveUnpacker;
 
 class Engine {
 public:
+    /// Where frames go.  Offscreen renders into a hidden window on SDL's
+    /// "offscreen" video driver (an EGL pbuffer, so a software GL such as
+    /// llvmpipe works without a GPU or display).  Null creates no window or
+    /// GL context: recorded GL is counted and dropped, while scenes, physics,
+    /// streaming and batching run as usual.
+    enum class RenderBackend { Window, Offscreen, Null };
+
     Engine();
     ~Engine();
 
@@ -33,8 +40,37 @@ public:
 
     void Quit();
 
+    /// Frame cap (0 = uncapped).  Ignored when vsync is on.
     void SetFPS(const int& fps);
 
+    /// Pace frames by the display's refresh instead of the FPS cap.
+    /// Takes effect at Run().
+    void SetVSync(bool enabled);
+
+    /// Rate of Component::FixedUpdate (default 60).  At most
+    /// `maxStepsPerFrame` ticks run per frame; a larger backlog is dropped.
+    void SetTickRate(int ticksPerSecond, int maxStepsPerFrame = 8);
+
+    /// Replay frames on a render thread (default) or, for debugging, on the
+    /// main thread at the end of each tick.  `maxQueuedFrames` caps how many
+    /// recorded frames may wait for the GPU.  Takes effect at Run().
+    void SetRenderThreading(bool threaded, int maxQueuedFrames = 1);
+
+    /// Default Window.  Offscreen falls back to Null when no GL context can
+    /// be created.  Takes effect at Run().
+    void SetRenderBackend(RenderBackend backend);
+
+    /// Stop after `frames` frames (0 = run until closed), for benchmarks
+    /// and CI.  Prints frame-time and command statistics on exit.
+    void SetFrameLimit(int frames);
+
+    /// Apply engine options given on the command line:
+    ///   --headless          offscreen rendering
+    ///   --headless=null     no GL at all
+    ///   --frames=N          see SetFrameLimit
+    ///   --uncapped          no frame cap
+    void ParseCommandLine(int argc, char* argv[]);
+
 private:
     class Impl;
     Impl* impl;
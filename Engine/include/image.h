@@ -7,6 +7,7 @@
 #include "Scene.h"
 #include "engine.h"
 #include "ArchiveUnpacker.h"
+#include "ResourceManager.h"
 
 class Image : public Component
 {
@@ -23,33 +24,59 @@ public:
         sprite = nullptr;
         this->size = size;
     }
+    /// Show an already-loaded shared texture (no decode, no copy of the bytes).
+    Image(const TextureHandle &texture, Vector2 size = Vector2(0, 0))
+    {
+        this->texture = texture;
+        sprite = nullptr;
+        this->size = size;
+    }
 
     void Init() override
     {
-        SetNewSprite(imgData);
+        if (texture)
+            SetTexture(texture);
+        else
+            SetNewSprite(imgData);
     }
 
+    /// Show new image bytes.  Identical bytes resolve to the texture already
+    /// in ResourceManager, so this only decodes images it hasn't seen yet.
     void SetNewSprite(const std::vector<unsigned char> &imgData)
     {
-        if (sprite != nullptr)
-            delete sprite;
-        sprite = object->GetScene()->createSprite(imgData);
-        this->imgData = imgData;
-        if (!sprite)
-        {
-            sprite = object->GetScene()->createSprite(Engine::GetDefaultArchive()->GetFile("ImageDefault.png"));
-            this->imgData = Engine::GetDefaultArchive()->GetFile("ImageDefault.png");
-        }
-        if (sprite != nullptr)
-        {
-            if (size == Vector2(0, 0))
-                size = sprite->getSize();
-            SetSize(size);
+        TextureHandle tex = ResourceManager::Get().AcquireTexture(imgData);
+        if (!tex)
+            tex = ResourceManager::Get().AcquireTexture(Engine::GetDefaultArchive()->GetFile("ImageDefault.png"));
+        SetTexture(tex);
+    }
 
-            object->InitSize(this);
-        }
+    /// Swap the shared texture shown by this image.  Cheap: the sprite, its
+    /// size and colour are kept, only the texture reference changes.
+    void SetTexture(const TextureHandle &newTexture)
+    {
+        texture = newTexture;
+        this->imgData.clear();
+        this->imgData.shrink_to_fit();
+        if (!object)
+            return;
+        if (sprite == nullptr)
+            sprite = object->GetScene()->createSprite(texture);
+        else
+            sprite->setTexture(texture);
+
+        if (size == Vector2(0, 0))
+            size = sprite->getSize();
+        SetSize(size);
+
+        object->InitSize(this);
     }
-    /// Called by RenderSystem — performs the actual OpenGL draw.
+
+    const TextureHandle &GetTexture() const
+    {
+        return texture;
+    }
+
+    /// Called by RenderSystem — queues the sprite into SpriteBatch.
     void Render()
     {
         if (sprite != nullptr)
@@ -59,7 +86,7 @@ public:
             if (objSize.x > 0 && objSize.y > 0) {
                 sprite->setSize((int)objSize.x, (int)objSize.y);
             }
-            sprite->draw(object->GetPosition(), object->GetAngle().z);
+            sprite->draw(object->GetRenderWorldPosition3D().toVector2(), object->GetRenderWorldAngle().z);
         }
     }
 
@@ -86,6 +113,8 @@ public:
 
     virtual Image *Clone() const override
     {
+        if (texture)
+            return new Image(texture, size);
         return new Image(imgData, size);
     }
 
@@ -95,7 +124,8 @@ public:
     }
 
 private:
-    std::vector<unsigned char> imgData;
+    std::vector<unsigned char> imgData;   // pending bytes, until Init resolves them
+    TextureHandle texture;
     Sprite *sprite;
     Vector2 size;
 };
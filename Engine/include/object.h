@@ -2,7 +2,9 @@
 #define OBJECT_H
 
 #include <SDL.h>
+#include <cstdint>
 #include <vector>
+#include <glm/glm.hpp>
 #include "Utils.h"
 
 
@@ -29,6 +31,39 @@ public:
 
     Vector2 GetSize();
     Vector3 GetSize3D() const { return size; }
+
+    // ── Hierarchy ──
+    // Position and rotation are local to the parent.  The world matrix
+    // (translate x rotate X/Y/Z, no size) is cached and rebuilt only after
+    // a setter marks the object dirty or its parent's matrix changed.
+    /// Attach to `newParent` (nullptr = root).  Ignored if it would form a cycle.
+    void SetParent(Object* newParent);
+    Object* GetParent() const { return parent; }
+    const std::vector<Object*>& GetChildren() const { return children; }
+    const glm::mat4& GetWorldMatrix() const;
+    Vector3 GetWorldPosition3D() const;
+    /// Bumped every time the world matrix is rebuilt; lets consumers cache
+    /// data derived from it (see Model3DComponent).
+    uint32_t GetWorldVersion() const { GetWorldMatrix(); return m_worldVersion; }
+
+    // ── Fixed-step interpolation ──
+    // Objects moved by Component::FixedUpdate change at the tick rate.
+    // Rendering blends the last two ticks by the fraction of a tick
+    // elapsed (Scene::InterpolateTransforms), so motion is smooth at any
+    // frame rate.  A value changed outside a fixed step (Update, teleports)
+    // is drawn as is.
+    Vector3 GetRenderPosition3D() const { return m_renderPosition; }
+    Vector3 GetRenderAngle() const { return m_renderAngle; }
+    /// World matrix of the interpolated transform; equals GetWorldMatrix()
+    /// unless IsRenderInterpolated().
+    const glm::mat4& GetRenderMatrix() const { return m_renderInterpolated ? m_renderMatrix : GetWorldMatrix(); }
+    /// World-space render position (translation of GetRenderMatrix()), for
+    /// sprites, text and anything else that doesn't draw with the matrix.
+    Vector3 GetRenderWorldPosition3D() const;
+    /// Render angle plus the render angles of every parent.  Exact for
+    /// rotation about one axis, i.e. 2D objects turning about z.
+    Vector3 GetRenderWorldAngle() const;
+    bool IsRenderInterpolated() const { return m_renderInterpolated; }
     void InitSize(Image* img);
     void InitSize();
     void SetLayer(int layer);
@@ -40,6 +75,7 @@ public:
     void RemoveComponent();
   
     void update(float deltaTime);
+    void fixedUpdate(float fixedDeltaTime);
     void lateUpdate(float deltaTime);
     Scene* GetScene() const;
     void UpdateEvents(SDL_Event& event);
@@ -63,6 +99,12 @@ public:
 private:
     virtual ~Object();
     Object(Scene* _game);
+    void markTransformDirty() { m_transformDirty = true; }
+    void rebuildWorldMatrix() const;
+    void updateWorldTransform();   // batched pass, called by Scene in hierarchy order
+    void beginFixedStep();
+    void endFixedStep();
+    void updateRenderTransform(float alpha);   // called by Scene in hierarchy order
     Scene* currentScene;
     std::vector<Component*> components;
     Vector3 position;
@@ -72,6 +114,20 @@ private:
     bool active; 
     bool m_isStatic = false;
     float deltatime;
+
+    Object* parent = nullptr;
+    std::vector<Object*> children;
+    mutable glm::mat4 m_worldMatrix = glm::mat4(1.0f);
+    mutable uint32_t m_worldVersion = 0;
+    mutable uint32_t m_parentVersion = 0;    // parent's m_worldVersion when last rebuilt
+    mutable bool m_transformDirty = true;
+
+    Vector3 m_tickStartPosition, m_tickStartAngle;   // at the start of the last fixed step
+    Vector3 m_tickEndPosition, m_tickEndAngle;       // at its end
+    Vector3 m_renderPosition, m_renderAngle;
+    glm::mat4 m_renderMatrix = glm::mat4(1.0f);
+    bool m_renderInterpolated = false;
+    bool m_inFixedStep = false;
    
   
 
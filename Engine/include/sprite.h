@@ -5,14 +5,16 @@
 #include <SDL.h>
 #include <GL/glew.h>
 #include "Utils.h"  
+#include "ResourceManager.h"
 #include <glm/glm.hpp>
 
 class Sprite {
 public:
   
     Sprite(const std::vector<unsigned char>& imageData);
-    ~Sprite();
+    Sprite(const TextureHandle& texture);
 
+    /// Queue the sprite in SpriteBatch; it is drawn at the next flush.
     void draw();
     void draw(const Vector2& pos, float angle);
 
@@ -20,14 +22,15 @@ public:
     void setAngle(float angle);
     void setSize(int width, int height);
     Vector2 getSize() const;
+    GLuint getTextureID() const { return texture.GetID(); }
+    const TextureHandle& getTexture() const { return texture; }
+    /// Show a different shared texture; the size is left unchanged.
+    void setTexture(const TextureHandle& newTexture) { texture = newTexture; }
+    bool isValid() const { return (bool)texture; }
     void SetColorAndOpacity(Uint8 red, Uint8 green, Uint8 blue, float alpha);
 
 private:
-    bool loadTextureFromMemory(const std::vector<unsigned char>& imageData);
-    void initRenderData();
-
-    GLuint textureID;
-    GLuint VAO, VBO, EBO;
+    TextureHandle texture;
     int width, height;
     int posX, posY;
     float rotation;
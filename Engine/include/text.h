@@ -3,12 +3,12 @@
 
 #include "component.h"
 #include <SDL.h>
-#include <SDL_ttf.h>
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 #include <string>
 #include <vector>
 #include "color.h"
+#include "FontAtlas.h"
 
 enum class TextAlignment {
     LEFT,
@@ -16,6 +16,14 @@ enum class TextAlignment {
     RIGHT
 };
 
+/// How glyphs are rasterised.  DistanceField (the default) shares one atlas
+/// per font across every size and supports outlines; Bitmap uses an atlas
+/// rasterised at exactly the font size, for pixel-exact small text.
+enum class TextRenderMode {
+    DistanceField,
+    Bitmap
+};
+
 class TextComponent : public Component
 {
 public:
@@ -26,45 +34,55 @@ public:
     TextComponent(int fontSize,
            const std::string& text,
            TextAlignment align = TextAlignment::LEFT);
-    ~TextComponent();
 
     void setText(const std::string& newText);
     void setColor(const Color& newColor);
     void setColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a = 255) { setColor(Color(r, g, b, a)); }
     void setAlignment(TextAlignment newAlignment);
+    void setFontSize(int newSize);
+    void setRenderMode(TextRenderMode newMode);
+    /// Outline of `width` pixels around the glyphs (distance-field mode only).
+    void setOutline(const Color& outlineColor, float width);
 
     virtual void Init() override;
 
-    /// Called by RenderSystem — performs the actual OpenGL draw.
+    /// Called by RenderSystem — queues the laid-out glyph quads into SpriteBatch.
     void Render();
 
+    // Sort-key input for the render queue (the shared glyph atlas)
+    GLuint GetTextureID() const { return atlas ? atlas->GetTextureID() : 0; }
+
     virtual TextComponent* Clone() const override {
-        return new TextComponent(fontSize, text, color, alignment);
+        TextComponent* copy = new TextComponent(fontSize, text, color, alignment);
+        copy->renderMode = renderMode;
+        copy->outlineColor = outlineColor;
+        copy->outlineWidth = outlineWidth;
+        return copy;
     }
 
 private:
-    bool createTextureFromSurface(SDL_Surface* surface);
-    void updateTexture();     
-    void initRenderData();    
+    void selectAtlas();
+    void layout();
 
-   
 private:
     int fontSize;
     std::string text;
     Color color;
     TextAlignment alignment;
+    TextRenderMode renderMode = TextRenderMode::DistanceField;
+    Color outlineColor = Color(0, 0, 0, 255);
+    float outlineWidth = 0.0f;
 
-    
-    TTF_Font* font;
-    std::vector<unsigned char> fontDataBuffer;
-
-    
-    GLuint textureID;
-    int textWidth;
-    int textHeight;
+    FontAtlas* atlas;
 
-    
-    GLuint VAO, VBO, EBO;
+    // Glyphs of `text` in pixels from the line's top-left (rebuilt by setText)
+    struct GlyphQuad {
+        float x, y, w, h;
+        const FontAtlas::Glyph* glyph;
+    };
+    std::vector<GlyphQuad> quads;
+    float textWidth;
+    float textHeight;
 };
 
 #endif // TEXT_GL_H
@@ -4,14 +4,18 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 glm::mat4 CameraComponent::GetViewMatrix() const {
-    Vector3 pos = object->GetPosition3D();
-    Vector3 ang = object->GetAngle();
+    // Interpolated between fixed steps, like every drawn object
+    Vector3 pos = object->GetRenderPosition3D();
+    Vector3 ang = object->GetRenderAngle();
     glm::mat4 view = glm::mat4(1.0f);
     // Yaw-Pitch-Roll rotations (Z after Y after X)
     view = glm::rotate(view, glm::radians(ang.x), glm::vec3(1,0,0));
     view = glm::rotate(view, glm::radians(ang.y), glm::vec3(0,1,0));
     view = glm::rotate(view, glm::radians(ang.z), glm::vec3(0,0,1));
     view = glm::translate(view, glm::vec3(-pos.x, -pos.y, -pos.z));
+    // Position and angles are local to the parent: undo its transform first
+    if (Object* parent = object->GetParent())
+        view = view * glm::inverse(parent->GetRenderMatrix());
     return view;
 }
 
@@ -0,0 +1,136 @@
+#include "CpuProfiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+// The ring's owner keeps writing while a dump reads it; skipping this many
+// of the oldest events leaves room so the dump never reads a slot that is
+// being overwritten.
+static constexpr uint64_t kDumpSlack = CpuProfiler::kEventsPerThread / 8;
+
+thread_local CpuProfiler::ThreadBuffer* CpuProfiler::t_buffer = nullptr;
+
+CpuProfiler& CpuProfiler::Get() {
+    static CpuProfiler instance;
+    return instance;
+}
+
+CpuProfiler::CpuProfiler()
+    : m_epoch(now())
+{
+}
+
+int64_t CpuProfiler::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+CpuProfiler::ThreadBuffer& CpuProfiler::threadBuffer()
+{
+    if (!t_buffer) {
+        auto buffer = std::make_unique<ThreadBuffer>();
+        buffer->events.reset(new Event[kEventsPerThread]);
+        std::lock_guard<std::mutex> lock(m_threadsMutex);
+        buffer->id = (int)m_threads.size() + 1;
+        buffer->name = "Thread " + std::to_string(buffer->id);
+        t_buffer = buffer.get();
+        m_threads.push_back(std::move(buffer));
+    }
+    return *t_buffer;
+}
+
+void CpuProfiler::record(const char* name, int64_t start, int64_t end)
+{
+    ThreadBuffer& buffer = threadBuffer();
+    uint64_t head = buffer.head.load(std::memory_order_relaxed);
+    buffer.events[head % kEventsPerThread] = Event{name, start, end - start};
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+void CpuProfiler::SetThreadName(const char* name)
+{
+    CpuProfiler& profiler = Get();
+    ThreadBuffer& buffer = profiler.threadBuffer();
+    std::lock_guard<std::mutex> lock(profiler.m_threadsMutex);
+    buffer.name = name;
+}
+
+// ── Dumps ────────────────────────────────────────────────────────────────────
+
+void CpuProfiler::ProcessEvent(const SDL_Event& event)
+{
+    if (event.type == SDL_KEYDOWN && !event.key.repeat &&
+        m_dumpKey != SDLK_UNKNOWN && event.key.keysym.sym == m_dumpKey)
+        RequestDump();
+}
+
+void CpuProfiler::DumpAfterFrames(int frames, const std::string& path)
+{
+    if (frames <= 0) {
+        RequestDump(path);
+        return;
+    }
+    m_framesUntilDump = frames;
+    m_dumpPath = path;
+}
+
+void CpuProfiler::RequestDump(const std::string& path)
+{
+    m_dumpRequested = true;
+    m_dumpPath = path;
+}
+
+void CpuProfiler::EndFrame()
+{
+    if (m_framesUntilDump > 0 && --m_framesUntilDump == 0)
+        m_dumpRequested = true;
+    if (!m_dumpRequested) return;
+    m_dumpRequested = false;
+    if (WriteTrace(m_dumpPath))
+        std::cout << "CpuProfiler: trace written to '" << m_dumpPath << "'" << std::endl;
+}
+
+bool CpuProfiler::WriteTrace(const std::string& path)
+{
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        std::cerr << "CpuProfiler: cannot write '" << path << "'" << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_threadsMutex);
+    std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+    bool first = true;
+    for (const auto& buffer : m_threads) {
+        std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                     first ? "" : ",\n", buffer->id, buffer->name.c_str());
+        first = false;
+
+        uint64_t head = buffer->head.load(std::memory_order_acquire);
+        uint64_t begin = head > kEventsPerThread ? head - kEventsPerThread + kDumpSlack : 0;
+        for (uint64_t i = begin; i < head; ++i) {
+            const Event& e = buffer->events[i % kEventsPerThread];
+            // Timestamps in microseconds since the profiler started
+            std::fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                         e.name, buffer->id, (e.start - m_epoch) * 1e-3, e.duration * 1e-3);
+        }
+    }
+    std::fputs("\n]}\n", file);
+    return std::fclose(file) == 0;
+}
+
+// ── Scope ────────────────────────────────────────────────────────────────────
+
+CpuProfiler::Scope::Scope(const char* name)
+    : m_name(name)
+    , m_start(CpuProfiler::Get().IsEnabled() ? now() : -1)
+{
+}
+
+CpuProfiler::Scope::~Scope()
+{
+    if (m_start < 0) return;
+    CpuProfiler::Get().record(m_name, m_start, now());
+}
@@ -0,0 +1,206 @@
+#include "FontAtlas.h"
+#include "ArchiveUnpacker.h"
+#include "engine.h"
+#include "RenderThread.h"
+#include "GLState.h"
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <unordered_map>
+
+static std::unordered_map<std::string, std::unique_ptr<FontAtlas>>& atlases() {
+    static std::unordered_map<std::string, std::unique_ptr<FontAtlas>> cache;
+    return cache;
+}
+
+/// Tightly packed RGBA pixels of one glyph.
+struct GlyphRaster {
+    int w = 0, h = 0;
+    std::vector<unsigned char> rgba;
+};
+
+// Replace a glyph's coverage by a signed distance field `spread` pixels
+// larger on each side.  Alpha 0.5 is the edge and each step of 0.5 / spread
+// is one source pixel inside (up) or outside (down).  Brute force within
+// the spread radius: it runs once per glyph, when the atlas is built.
+static GlyphRaster distanceField(const GlyphRaster& src, int spread)
+{
+    auto inside = [&](int x, int y) {
+        if (x < 0 || y < 0 || x >= src.w || y >= src.h) return false;
+        return src.rgba[((size_t)y * src.w + x) * 4 + 3] >= 128;
+    };
+
+    GlyphRaster out;
+    out.w = src.w + 2 * spread;
+    out.h = src.h + 2 * spread;
+    out.rgba.resize((size_t)out.w * out.h * 4);
+    const int maxSq = spread * spread;
+    for (int oy = 0; oy < out.h; ++oy) {
+        for (int ox = 0; ox < out.w; ++ox) {
+            int sx = ox - spread, sy = oy - spread;
+            bool in = inside(sx, sy);
+            int best = maxSq;
+            for (int dy = -spread; dy <= spread; ++dy)
+                for (int dx = -spread; dx <= spread; ++dx) {
+                    int d2 = dx * dx + dy * dy;
+                    if (d2 < best && inside(sx + dx, sy + dy) != in)
+                        best = d2;
+                }
+            // The edge lies half a pixel from the nearest opposite pixel
+            float dist = std::sqrt((float)best) - 0.5f;
+            float value = 0.5f + (in ? dist : -dist) / (2.0f * spread);
+            unsigned char* p = &out.rgba[((size_t)oy * out.w + ox) * 4];
+            p[0] = p[1] = p[2] = 255;
+            p[3] = (unsigned char)(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+        }
+    }
+    return out;
+}
+
+static FontAtlas* findAtlas(const std::string& key)
+{
+    auto it = atlases().find(key);
+    return it != atlases().end() ? it->second.get() : nullptr;
+}
+
+FontAtlas* FontAtlas::Get(const std::string& fontFile, int size)
+{
+    std::string key = fontFile + "#" + std::to_string(size);
+    if (FontAtlas* atlas = findAtlas(key)) return atlas;
+
+    // A failed build is cached too, so a missing font isn't retried per label
+    std::unique_ptr<FontAtlas> atlas(new FontAtlas());
+    if (!atlas->build(Engine::GetDefaultArchive()->GetFile(fontFile), size, 0))
+        std::cerr << "FontAtlas: cannot build '" << fontFile << "' at size " << size << std::endl;
+    return atlases().emplace(key, std::move(atlas)).first->second.get();
+}
+
+FontAtlas* FontAtlas::GetDistanceField(const std::string& fontFile)
+{
+    std::string key = fontFile + "#sdf";
+    if (FontAtlas* atlas = findAtlas(key)) return atlas;
+
+    std::unique_ptr<FontAtlas> atlas(new FontAtlas());
+    if (!atlas->build(Engine::GetDefaultArchive()->GetFile(fontFile), kDistanceFieldSize, kDistanceFieldSpread))
+        std::cerr << "FontAtlas: cannot build distance field for '" << fontFile << "'" << std::endl;
+    return atlases().emplace(key, std::move(atlas)).first->second.get();
+}
+
+void FontAtlas::ReleaseAll()
+{
+    atlases().clear();
+}
+
+FontAtlas::~FontAtlas()
+{
+    if (m_texture) {
+        GLContextLock gl;
+        glDeleteTextures(1, &m_texture);
+    }
+}
+
+const FontAtlas::Glyph& FontAtlas::GetGlyph(char c) const
+{
+    int code = (unsigned char)c;
+    if (code < kFirstChar || code > kLastChar) code = '?';
+    return m_glyphs[code - kFirstChar];
+}
+
+bool FontAtlas::build(const std::vector<unsigned char>& fontData, int size, int spread)
+{
+    if (fontData.empty()) return false;
+    SDL_RWops* rw = SDL_RWFromConstMem(fontData.data(), (int)fontData.size());
+    if (!rw) return false;
+    TTF_Font* font = TTF_OpenFontRW(rw, 1, size);
+    if (!font) {
+        std::cerr << "FontAtlas: " << TTF_GetError() << std::endl;
+        return false;
+    }
+    m_lineHeight = TTF_FontHeight(font);
+    m_rasterSize = size;
+    m_spread = spread;
+
+    // Rasterise every glyph, then place them left to right in shelves.
+    // Glyph surfaces are a full line tall with the glyph on the baseline,
+    // so laying quads out at the pen position reproduces TTF_RenderText.
+    const SDL_Color white = {255, 255, 255, 255};
+    GlyphRaster rasters[kGlyphCount];
+    int slotX[kGlyphCount] = {}, slotY[kGlyphCount] = {};
+    int x = kPadding, y = kPadding, shelfHeight = 0;
+    for (int i = 0; i < kGlyphCount; ++i) {
+        Uint16 ch = (Uint16)(kFirstChar + i);
+        int minx, maxx, miny, maxy, advance;
+        if (TTF_GlyphMetrics(font, ch, &minx, &maxx, &miny, &maxy, &advance) != 0)
+            continue;
+        m_glyphs[i].advance = advance;
+
+        SDL_Surface* glyph = TTF_RenderGlyph_Blended(font, ch, white);
+        if (!glyph) continue;
+        SDL_Surface* rgba = SDL_ConvertSurfaceFormat(glyph, SDL_PIXELFORMAT_RGBA32, 0);
+        SDL_FreeSurface(glyph);
+        if (!rgba) continue;
+        GlyphRaster raster;
+        raster.w = rgba->w;
+        raster.h = rgba->h;
+        raster.rgba.resize((size_t)raster.w * raster.h * 4);
+        for (int row = 0; row < raster.h; ++row)
+            std::memcpy(&raster.rgba[(size_t)row * raster.w * 4],
+                        (const unsigned char*)rgba->pixels + row * rgba->pitch, (size_t)raster.w * 4);
+        SDL_FreeSurface(rgba);
+        if (raster.w == 0) continue;
+        if (spread > 0) raster = distanceField(raster, spread);
+        if (raster.w + 2 * kPadding > kAtlasWidth) continue;
+
+        if (x + raster.w + kPadding > kAtlasWidth) {
+            x = kPadding;
+            y += shelfHeight + kPadding;
+            shelfHeight = 0;
+        }
+        slotX[i] = x;
+        slotY[i] = y;
+        x += raster.w + kPadding;
+        shelfHeight = std::max(shelfHeight, raster.h);
+        rasters[i] = std::move(raster);
+    }
+    TTF_CloseFont(font);
+
+    int height = 1;
+    while (height < y + shelfHeight + kPadding) height <<= 1;
+
+    std::vector<unsigned char> pixels((size_t)kAtlasWidth * height * 4, 0);
+    for (int i = 0; i < kGlyphCount; ++i) {
+        const GlyphRaster& r = rasters[i];
+        if (r.w == 0) continue;
+        for (int row = 0; row < r.h; ++row)
+            std::memcpy(&pixels[((size_t)(slotY[i] + row) * kAtlasWidth + slotX[i]) * 4],
+                        &r.rgba[(size_t)row * r.w * 4], (size_t)r.w * 4);
+
+        Glyph& g = m_glyphs[i];
+        g.offsetX = -spread;
+        g.offsetY = -spread;
+        g.width = r.w;
+        g.height = r.h;
+        g.u0 = slotX[i] / (float)kAtlasWidth;
+        g.v0 = slotY[i] / (float)height;
+        g.u1 = (slotX[i] + r.w) / (float)kAtlasWidth;
+        g.v1 = (slotY[i] + r.h) / (float)height;
+    }
+
+    if (RenderThread::Get().IsNullBackend()) return true;   // metrics only, no texture
+    // Recorded, so a text label built mid-frame doesn't wait for queued frames
+    m_texture = RenderThread::Get().AllocateName(RenderThread::NameTexture);
+    RecordGL([texture = m_texture, height, pixels = std::move(pixels)] {
+        GLState::Get().BindTexture(0, GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, kAtlasWidth, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    });
+    return true;
+}
@@ -0,0 +1,71 @@
+#include "FrameUniforms.h"
+#include "LightComponent.h"
+#include "RenderThread.h"
+#include "GLState.h"
+
+const char* const FrameUniforms::kBlockSource = R"(
+layout(std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 lightVPs[4];
+    vec4 cascadeSplits;     // view-space far distance of each cascade
+    vec4 lightDir;          // xyz: light direction (world)
+    vec4 lightColor;        // rgb
+    vec4 ambientColor;      // rgb
+    ivec4 shadowParams;     // x = useShadows, y = cascadeCount, z = PCF taps (x, z: for reference; variants compile them in)
+};
+)";
+
+FrameUniforms& FrameUniforms::Get() {
+    static FrameUniforms instance;
+    return instance;
+}
+
+void FrameUniforms::Update(const glm::mat4& view, const glm::mat4& projection, const LightComponent* light)
+{
+    Block block;
+    block.view = view;
+    block.projection = projection;
+    for (auto& vp : block.lightVPs) vp = glm::mat4(1.0f);
+    block.cascadeSplits = glm::vec4(0.0f);
+    block.lightDir = glm::vec4(0.0f, 0.0f, -1.0f, 0.0f);
+    block.lightColor = glm::vec4(1.0f);
+    block.ambientColor = glm::vec4(0.2f, 0.2f, 0.2f, 1.0f);
+    block.shadowParams = glm::ivec4(0, 1, 1, 0);
+
+    if (light) {
+        block.lightDir = glm::vec4(light->GetDirection(), 0.0f);
+        block.lightColor = glm::vec4(light->GetColor(), 1.0f);
+        block.ambientColor = glm::vec4(light->GetAmbient(), 1.0f);
+        if (light->IsShadowEnabled() && light->GetDepthTexture()) {
+            int cascades = light->GetCascadeCount();
+            for (int i = 0; i < cascades; ++i) {
+                block.lightVPs[i] = light->GetCascadeVP(i);
+                block.cascadeSplits[i] = light->GetCascadeSplit(i);
+            }
+            block.shadowParams = glm::ivec4(1, cascades, light->GetShadowFilterTaps(), 0);
+        }
+    }
+
+    if (!m_ubo) {
+        if (RenderThread::Get().IsNullBackend()) return;
+        m_ubo = RenderThread::Get().AllocateName(RenderThread::NameBuffer);
+        RecordGL([ubo = m_ubo] {
+            GLState::Get().BindBuffer(GL_UNIFORM_BUFFER, ubo);
+            glBufferData(GL_UNIFORM_BUFFER, sizeof(Block), nullptr, GL_DYNAMIC_DRAW);
+            glBindBufferBase(GL_UNIFORM_BUFFER, kBindingPoint, ubo);
+        });
+    }
+    GLuint ubo = m_ubo;
+    RecordGL([ubo, block] {
+        GLState::Get().BindBuffer(GL_UNIFORM_BUFFER, ubo);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Block), &block);
+    });
+}
+
+void FrameUniforms::Release()
+{
+    GLContextLock gl;
+    if (m_ubo) glDeleteBuffers(1, &m_ubo);
+    m_ubo = 0;
+}
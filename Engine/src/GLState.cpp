@@ -0,0 +1,282 @@
+#include "GLState.h"
+#include <glm/gtc/type_ptr.hpp>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+
+GLState& GLState::Get() {
+    static GLState instance;
+    return instance;
+}
+
+void GLState::Invalidate()
+{
+    m_program = kUnknown;
+    m_vao = kUnknown;
+    m_activeUnit = kUnknown;
+    for (int i = 0; i < kTextureUnits; ++i) {
+        m_textures2D[i] = kUnknown;
+        m_textures2DArray[i] = kUnknown;
+    }
+    m_arrayBuffer = kUnknown;
+    m_uniformBuffer = kUnknown;
+    m_drawFramebuffer = kUnknown;
+    m_readFramebuffer = kUnknown;
+
+    m_depthTest = m_blend = m_cullFace = m_scissorTest = m_depthClamp = -1;
+    m_blendSource = m_blendDestination = m_depthFunc = m_cullMode = kUnknown;
+    m_viewport[0] = m_viewport[1] = m_viewport[2] = m_viewport[3] = -1;
+
+    // Relinked programs start from default uniform values
+    m_uniforms.clear();
+}
+
+void GLState::InvalidateBindings()
+{
+    m_vao = kUnknown;
+    m_arrayBuffer = kUnknown;
+    m_uniformBuffer = kUnknown;
+    m_drawFramebuffer = kUnknown;
+    m_readFramebuffer = kUnknown;
+
+    // Textures were bound on whichever unit was active
+    for (int i = 0; i < kTextureUnits; ++i) {
+        if (m_activeUnit != kUnknown && (GLuint)i != m_activeUnit) continue;
+        m_textures2D[i] = kUnknown;
+        m_textures2DArray[i] = kUnknown;
+    }
+}
+
+void GLState::Forget(Kind kind, const GLuint* names, int count)
+{
+    for (int n = 0; n < count; ++n) {
+        GLuint name = names[n];
+        switch (kind) {
+        case KindProgram:
+            if (m_program == name) m_program = kUnknown;
+            for (auto it = m_uniforms.begin(); it != m_uniforms.end();)
+                it = (GLuint)(it->first >> 32) == name ? m_uniforms.erase(it) : std::next(it);
+            break;
+        case KindVertexArray:
+            if (m_vao == name) m_vao = kUnknown;
+            break;
+        case KindTexture:
+            for (int i = 0; i < kTextureUnits; ++i) {
+                if (m_textures2D[i] == name) m_textures2D[i] = kUnknown;
+                if (m_textures2DArray[i] == name) m_textures2DArray[i] = kUnknown;
+            }
+            break;
+        case KindBuffer:
+            if (m_arrayBuffer == name) m_arrayBuffer = kUnknown;
+            if (m_uniformBuffer == name) m_uniformBuffer = kUnknown;
+            break;
+        case KindFramebuffer:
+            if (m_drawFramebuffer == name) m_drawFramebuffer = kUnknown;
+            if (m_readFramebuffer == name) m_readFramebuffer = kUnknown;
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+// ── Bindings ─────────────────────────────────────────────────────────────────
+
+void GLState::UseProgram(GLuint program)
+{
+    if (!changed(KindProgram, program != m_program)) return;
+    glUseProgram(program);
+    m_program = program;
+}
+
+void GLState::BindVertexArray(GLuint vao)
+{
+    if (!changed(KindVertexArray, vao != m_vao)) return;
+    glBindVertexArray(vao);
+    m_vao = vao;
+}
+
+void GLState::activeTexture(GLuint unit)
+{
+    if (!changed(KindTexture, unit != m_activeUnit)) return;
+    glActiveTexture(GL_TEXTURE0 + unit);
+    m_activeUnit = unit;
+}
+
+void GLState::BindTexture(GLuint unit, GLenum target, GLuint texture)
+{
+    GLuint* slot = nullptr;
+    if (unit < (GLuint)kTextureUnits) {
+        if (target == GL_TEXTURE_2D) slot = &m_textures2D[unit];
+        else if (target == GL_TEXTURE_2D_ARRAY) slot = &m_textures2DArray[unit];
+    }
+    if (slot && !changed(KindTexture, texture != *slot)) return;
+    if (!slot) m_issued[KindTexture]++;
+    activeTexture(unit);
+    glBindTexture(target, texture);
+    if (slot) *slot = texture;
+}
+
+void GLState::BindBuffer(GLenum target, GLuint buffer)
+{
+    GLuint* slot = target == GL_ARRAY_BUFFER ? &m_arrayBuffer
+                 : target == GL_UNIFORM_BUFFER ? &m_uniformBuffer : nullptr;
+    if (slot && !changed(KindBuffer, buffer != *slot)) return;
+    if (!slot) m_issued[KindBuffer]++;
+    glBindBuffer(target, buffer);
+    if (slot) *slot = buffer;
+}
+
+void GLState::BindFramebuffer(GLenum target, GLuint framebuffer)
+{
+    bool draw = target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER;
+    bool read = target == GL_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER;
+    bool differs = (draw && framebuffer != m_drawFramebuffer) || (read && framebuffer != m_readFramebuffer);
+    if (!changed(KindFramebuffer, differs)) return;
+    glBindFramebuffer(target, framebuffer);
+    if (draw) m_drawFramebuffer = framebuffer;
+    if (read) m_readFramebuffer = framebuffer;
+}
+
+// ── Pipeline ─────────────────────────────────────────────────────────────────
+
+int* GLState::capabilitySlot(GLenum capability)
+{
+    switch (capability) {
+    case GL_DEPTH_TEST:   return &m_depthTest;
+    case GL_BLEND:        return &m_blend;
+    case GL_CULL_FACE:    return &m_cullFace;
+    case GL_SCISSOR_TEST: return &m_scissorTest;
+    case GL_DEPTH_CLAMP:  return &m_depthClamp;
+    default:              return nullptr;
+    }
+}
+
+void GLState::SetEnabled(GLenum capability, bool enabled)
+{
+    int* slot = capabilitySlot(capability);
+    if (slot && !changed(KindCapability, *slot != (int)enabled)) return;
+    if (!slot) m_issued[KindCapability]++;
+    if (enabled) glEnable(capability);
+    else glDisable(capability);
+    if (slot) *slot = enabled;
+}
+
+void GLState::BlendFunc(GLenum source, GLenum destination)
+{
+    if (!changed(KindPipeline, source != m_blendSource || destination != m_blendDestination)) return;
+    glBlendFunc(source, destination);
+    m_blendSource = source;
+    m_blendDestination = destination;
+}
+
+void GLState::DepthFunc(GLenum func)
+{
+    if (!changed(KindPipeline, func != m_depthFunc)) return;
+    glDepthFunc(func);
+    m_depthFunc = func;
+}
+
+void GLState::CullFace(GLenum mode)
+{
+    if (!changed(KindPipeline, mode != m_cullMode)) return;
+    glCullFace(mode);
+    m_cullMode = mode;
+}
+
+void GLState::Viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    bool differs = x != m_viewport[0] || y != m_viewport[1] || width != m_viewport[2] || height != m_viewport[3];
+    if (!changed(KindPipeline, differs)) return;
+    glViewport(x, y, width, height);
+    m_viewport[0] = x; m_viewport[1] = y; m_viewport[2] = width; m_viewport[3] = height;
+}
+
+// ── Uniforms ─────────────────────────────────────────────────────────────────
+
+bool GLState::uniformChanged(GLint location, const void* data, size_t size)
+{
+    if (m_program == kUnknown) return changed(KindUniform, true);   // can't attribute it to a program
+    UniformValue& last = m_uniforms[(uint64_t)m_program << 32 | (uint32_t)location];
+    bool differs = last.size != size || std::memcmp(last.data, data, size) != 0;
+    if (changed(KindUniform, differs)) {
+        last.size = (uint32_t)size;
+        std::memcpy(last.data, data, size);
+    }
+    return differs;
+}
+
+void GLState::SetUniform(GLint location, int value)
+{
+    if (location < 0 || !uniformChanged(location, &value, sizeof(value))) return;
+    glUniform1i(location, value);
+}
+
+void GLState::SetUniform(GLint location, float value)
+{
+    if (location < 0 || !uniformChanged(location, &value, sizeof(value))) return;
+    glUniform1f(location, value);
+}
+
+void GLState::SetUniform(GLint location, const glm::vec3& value)
+{
+    if (location < 0 || !uniformChanged(location, glm::value_ptr(value), sizeof(float) * 3)) return;
+    glUniform3fv(location, 1, glm::value_ptr(value));
+}
+
+void GLState::SetUniform(GLint location, const glm::vec4& value)
+{
+    if (location < 0 || !uniformChanged(location, glm::value_ptr(value), sizeof(float) * 4)) return;
+    glUniform4fv(location, 1, glm::value_ptr(value));
+}
+
+void GLState::SetUniform(GLint location, const glm::mat3& value)
+{
+    if (location < 0 || !uniformChanged(location, glm::value_ptr(value), sizeof(float) * 9)) return;
+    glUniformMatrix3fv(location, 1, GL_FALSE, glm::value_ptr(value));
+}
+
+void GLState::SetUniform(GLint location, const glm::mat4& value)
+{
+    if (location < 0 || !uniformChanged(location, glm::value_ptr(value), sizeof(float) * 16)) return;
+    glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
+}
+
+// ── Statistics ───────────────────────────────────────────────────────────────
+
+const char* GLState::GetKindName(Kind kind)
+{
+    static const char* const names[KindCount] = {
+        "program", "vao", "texture", "buffer", "framebuffer", "enable", "pipeline", "uniform"};
+    return names[kind];
+}
+
+void GLState::EndFrame()
+{
+    for (int k = 0; k < KindCount; ++k) {
+        m_lastIssued[k].store(m_issued[k], std::memory_order_relaxed);
+        m_lastSkipped[k].store(m_skipped[k], std::memory_order_relaxed);
+        m_issued[k] = m_skipped[k] = 0;
+    }
+}
+
+int GLState::GetTotalIssued() const
+{
+    int total = 0;
+    for (int k = 0; k < KindCount; ++k) total += GetIssued((Kind)k);
+    return total;
+}
+
+int GLState::GetTotalSkipped() const
+{
+    int total = 0;
+    for (int k = 0; k < KindCount; ++k) total += GetSkipped((Kind)k);
+    return total;
+}
+
+std::string GLState::FormatSummary() const
+{
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "GL state %d issued, %d skipped", GetTotalIssued(), GetTotalSkipped());
+    return buf;
+}
@@ -0,0 +1,133 @@
+#include "GpuProfiler.h"
+#include "RenderThread.h"
+#include <cstdio>
+
+// Weight of a new sample in the running average (~10-frame time constant)
+static constexpr float kSmoothing = 0.1f;
+
+GpuProfiler& GpuProfiler::Get() {
+    static GpuProfiler instance;
+    return instance;
+}
+
+const char* GpuProfiler::GetPassName(Pass pass)
+{
+    static const char* const names[PassCount] = {"shadow", "voxels", "models", "2D"};
+    return names[pass];
+}
+
+void GpuProfiler::SetEnabled(bool enabled)
+{
+    if (enabled == m_enabled) return;
+    m_enabled = enabled;
+    if (!enabled) {
+        // Unread queries are simply dropped; begun again, they are reused
+        RecordGL([this] {
+            for (auto& frame : m_frames) frame.issued.clear();
+        });
+        for (auto& ms : m_passMs) ms.store(0.0f, std::memory_order_relaxed);
+    }
+}
+
+float GpuProfiler::GetTotalMs() const
+{
+    float total = 0.0f;
+    for (int p = 0; p < PassCount; ++p)
+        total += GetPassMs((Pass)p);
+    return total;
+}
+
+std::string GpuProfiler::FormatSummary() const
+{
+    std::string line = "GPU";
+    char buf[48];
+    for (int p = 0; p < PassCount; ++p) {
+        std::snprintf(buf, sizeof(buf), " %s %.2f", GetPassName((Pass)p), GetPassMs((Pass)p));
+        line += buf;
+    }
+    std::snprintf(buf, sizeof(buf), " | total %.2f ms", GetTotalMs());
+    return line + buf;
+}
+
+void GpuProfiler::EndFrame()
+{
+    if (!m_enabled) return;
+    RecordGL([this] {
+        // The next slot was issued kFrameLatency - 1 frames ago
+        m_frame = (m_frame + 1) % kFrameLatency;
+        collect(m_frame);
+    });
+}
+
+// ── GL thread ────────────────────────────────────────────────────────────────
+
+void GpuProfiler::beginQuery(Pass pass)
+{
+    FrameQueries& frame = m_frames[m_frame];
+    size_t index = frame.issued.size();
+    if (index == frame.pool.size()) {
+        GLuint query;
+        glGenQueries(1, &query);
+        frame.pool.push_back(query);
+    }
+    frame.issued.push_back(Segment{frame.pool[index], pass});
+    glBeginQuery(GL_TIME_ELAPSED, frame.pool[index]);
+}
+
+void GpuProfiler::endQuery()
+{
+    glEndQuery(GL_TIME_ELAPSED);
+}
+
+void GpuProfiler::collect(int index)
+{
+    FrameQueries& frame = m_frames[index];
+    if (frame.issued.empty()) return;
+
+    // Results arrive in submission order: if the last one is ready, all are.
+    // Otherwise skip this frame's sample rather than wait for the GPU.
+    GLint available = 0;
+    glGetQueryObjectiv(frame.issued.back().query, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available) {
+        double passNs[PassCount] = {};
+        bool seen[PassCount] = {};
+        for (const Segment& s : frame.issued) {
+            GLuint64 ns = 0;
+            glGetQueryObjectui64v(s.query, GL_QUERY_RESULT, &ns);
+            passNs[s.pass] += (double)ns;
+            seen[s.pass] = true;
+        }
+        for (int p = 0; p < PassCount; ++p) {
+            float ms = seen[p] ? (float)(passNs[p] * 1e-6) : 0.0f;
+            float old = m_passMs[p].load(std::memory_order_relaxed);
+            m_passMs[p].store(old + (ms - old) * kSmoothing, std::memory_order_relaxed);
+        }
+    }
+    frame.issued.clear();
+}
+
+void GpuProfiler::Release()
+{
+    GLContextLock gl;
+    for (auto& frame : m_frames) {
+        if (!frame.pool.empty())
+            glDeleteQueries((GLsizei)frame.pool.size(), frame.pool.data());
+        frame.pool.clear();
+        frame.issued.clear();
+    }
+}
+
+// ── Scope ────────────────────────────────────────────────────────────────────
+
+GpuProfiler::Scope::Scope(Pass pass)
+    : m_active(GpuProfiler::Get().m_enabled)
+{
+    if (!m_active) return;
+    RecordGL([pass] { GpuProfiler::Get().beginQuery(pass); });
+}
+
+GpuProfiler::Scope::~Scope()
+{
+    if (!m_active) return;
+    RecordGL([] { GpuProfiler::Get().endQuery(); });
+}
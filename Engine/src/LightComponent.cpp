@@ -3,37 +3,54 @@
 #include "Scene.h"
 #include "object.h"
 #include "Model3DComponent.h"
+#include "ModelBatch.h"
 #include "CameraComponent.h"
 #include "IVoxelRenderer.h"
 #include "Frustum.h"
+#include "RenderThread.h"
+#include "GLState.h"
+#include "GpuProfiler.h"
+#include "ResourceManager.h"
 #include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
 #include <vector>
 #include <iostream>
 #include <cmath>
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
 
 namespace {
-GLuint compile(GLenum type, const char* src) {
-    GLuint s = glCreateShader(type);
-    glShaderSource(s, 1, &src, nullptr);
-    glCompileShader(s);
-    GLint ok=0; glGetShaderiv(s, GL_COMPILE_STATUS, &ok);
-    if(!ok){ char log[512]; glGetShaderInfoLog(s,512,nullptr,log); std::cerr << "Light shader compile: "<<log<<std::endl; }
-    return s;
+// Inside recorded commands only: the location cache lives on the GL thread
+void setLightVP(GLuint prog, const glm::mat4& lightVP) {
+    static std::unordered_map<GLuint, GLint> lightVPLocCache;
+    auto it = lightVPLocCache.find(prog);
+    if (it == lightVPLocCache.end())
+        it = lightVPLocCache.emplace(prog, glGetUniformLocation(prog, "lightVP")).first;
+    GLState::Get().SetUniform(it->second, lightVP);
 }
-GLuint link(GLuint vs, GLuint fs) {
-    GLuint p = glCreateProgram();
-    glAttachShader(p,vs); glAttachShader(p,fs);
-    glLinkProgram(p);
-    GLint ok=0; glGetProgramiv(p, GL_LINK_STATUS, &ok);
-    if(!ok){ char log[512]; glGetProgramInfoLog(p,512,nullptr,log); std::cerr << "Light program link: "<<log<<std::endl; }
-    glDeleteShader(vs); glDeleteShader(fs);
-    return p;
 }
+
+static const char* depthVertexShaderSource = R"(
+#version 330 core
+layout(location=0) in vec3 aPos;
+uniform mat4 model;
+uniform mat4 lightVP;
+void main(){
+    gl_Position = lightVP * model * vec4(aPos,1.0);
 }
+)";
+static const char* depthFragmentShaderSource = R"(
+#version 330 core
+void main(){ }
+)";
 
 static GLuint depthProgram = 0;
 
+void LightComponent::RegisterShaders()
+{
+    ResourceManager::Get().RegisterShader("shadow_depth", depthVertexShaderSource, depthFragmentShaderSource);
+}
+
 LightComponent::LightComponent()
     : direction(glm::normalize(glm::vec3(0.0f, -1.0f, 0.0f)))
     , color(1.0f, 1.0f, 1.0f)
@@ -43,95 +60,264 @@ LightComponent::LightComponent()
     , shadowHeight(1024)
     , depthFBO(0)
     , depthTexture(0)
-    , lightView(1.0f)
-    , lightProj(1.0f)
-{}
+{
+    for (int i = 0; i < kMaxCascades; ++i) {
+        cascadeView[i] = glm::mat4(1.0f);
+        cascadeProj[i] = glm::mat4(1.0f);
+        staticLightVP[i] = glm::mat4(1.0f);
+    }
+}
 
 LightComponent::~LightComponent()
 {
-    if (depthTexture) glDeleteTextures(1, &depthTexture);
-    if (depthFBO) glDeleteFramebuffers(1, &depthFBO);
+    releaseShadowResources();
 }
 
 void LightComponent::Init()
 {
-    if (depthProgram == 0) {
-        const char* vsSrc = R"(
-#version 330 core
-layout(location=0) in vec3 aPos;
-uniform mat4 model;
-uniform mat4 lightVP;
-void main(){
-    gl_Position = lightVP * model * vec4(aPos,1.0);
-}
-)";
-        const char* fsSrc = R"(
-#version 330 core
-void main(){ }
-)";
-        depthProgram = link(compile(GL_VERTEX_SHADER, vsSrc), compile(GL_FRAGMENT_SHADER, fsSrc));
-    }
+    depthProgram = ResourceManager::Get().GetShader("shadow_depth");
     ensureShadowResources();
 }
 
+void LightComponent::releaseShadowResources()
+{
+    GLContextLock gl;
+    if (depthTexture) glDeleteTextures(1, &depthTexture);
+    if (depthFBO) glDeleteFramebuffers(1, &depthFBO);
+    if (staticDepthTexture) glDeleteTextures(1, &staticDepthTexture);
+    if (staticFBO) glDeleteFramebuffers(1, &staticFBO);
+    depthTexture = depthFBO = staticDepthTexture = staticFBO = 0;
+    allocatedCascades = allocatedWidth = allocatedHeight = 0;
+}
+
 void LightComponent::ensureShadowResources()
 {
-    if (!enableShadows) return;
-    if (depthFBO == 0) glGenFramebuffers(1, &depthFBO);
-    if (depthTexture == 0) {
-        glGenTextures(1, &depthTexture);
-        glBindTexture(GL_TEXTURE_2D, depthTexture);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, shadowWidth, shadowHeight, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
-        float borderColor[] = {1.0,1.0,1.0,1.0};
-        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
-        glBindTexture(GL_TEXTURE_2D, 0);
-    }
-    glBindFramebuffer(GL_FRAMEBUFFER, depthFBO);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthTexture, 0);
+    if (!enableShadows || RenderThread::Get().IsNullBackend()) return;
+    if (depthTexture != 0 && allocatedCascades == cascadeCount &&
+        allocatedWidth == shadowWidth && allocatedHeight == shadowHeight)
+        return;
+
+    // Waits for queued frames that still sample the old maps
+    GLContextLock gl;
+    releaseShadowResources();
+    createDepthTarget(depthFBO, depthTexture);
+    createDepthTarget(staticFBO, staticDepthTexture);
+    allocatedCascades = cascadeCount;
+    allocatedWidth = shadowWidth;
+    allocatedHeight = shadowHeight;
+    staticValid = false;
+}
+
+void LightComponent::createDepthTarget(GLuint& fbo, GLuint& texture)
+{
+    // The names may be ones just deleted that GLState still has bound
+    GLState& state = GLState::Get();
+    glGenFramebuffers(1, &fbo);
+    glGenTextures(1, &texture);
+    state.Forget(GLState::KindFramebuffer, &fbo, 1);
+    state.Forget(GLState::KindTexture, &texture, 1);
+    state.BindTexture(0, GL_TEXTURE_2D_ARRAY, texture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, shadowWidth, shadowHeight, cascadeCount,
+                 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    float borderColor[] = {1.0,1.0,1.0,1.0};
+    glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, borderColor);
+    // Hardware depth comparison: with linear filtering each lookup returns a
+    // bilinearly weighted 2x2 PCF result. Blits ignore the compare mode.
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+
+    state.BindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, texture, 0, 0);
     glDrawBuffer(GL_NONE);
     glReadBuffer(GL_NONE);
     if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
         std::cerr << "Shadow framebuffer not complete" << std::endl;
     }
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    state.BindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 void LightComponent::computeLightMatrices(Scene* scene)
 {
-    // Camera-centered fixed shadow frustum — O(1) cost.
-    glm::vec3 center(0.0f);
+    // Camera parameters (fallback: default camera at the origin)
+    glm::mat4 camView(1.0f);
+    float fov = 60.0f, aspect = (float)Renderer::Get().GetWindowWidth() / (float)Renderer::Get().GetWindowHeight();
+    float nearZ = 0.1f, farZ = 100.0f;
+    if (CameraComponent* cam = CameraComponent::FindActive(scene)) {
+        camView = cam->GetViewMatrix();
+        fov = cam->GetFov(); aspect = cam->GetAspect();
+        nearZ = cam->GetNear(); farZ = cam->GetFar();
+    }
+    glm::mat4 invView = glm::inverse(camView);
+
+    // Practical split scheme: blend of logarithmic and uniform splits.
+    float n = nearZ;
+    float f = std::max(n + 0.01f, std::min(farZ, shadowDistance));
+    for (int i = 0; i < cascadeCount; ++i) {
+        float p = (float)(i + 1) / (float)cascadeCount;
+        float logSplit = n * std::pow(f / n, p);
+        float uniSplit = n + (f - n) * p;
+        cascadeSplits[i] = splitLambda * logSplit + (1.0f - splitLambda) * uniSplit;
+    }
+
+    float ty = std::tan(glm::radians(fov) * 0.5f);
+    float tx = ty * aspect;
+    float k = tx * tx + ty * ty;
+    glm::vec3 up = (std::abs(direction.y) > 0.99f) ? glm::vec3(0, 0, 1) : glm::vec3(0, 1, 0);
+
+    for (int i = 0; i < cascadeCount; ++i) {
+        float a = (i == 0) ? n : cascadeSplits[i - 1];
+        float b = cascadeSplits[i];
+
+        // Smallest sphere around the view-space slice [a, b].  It depends
+        // only on the projection, so it does not change as the camera turns.
+        float zc = std::min(b, 0.5f * (a + b) * (1.0f + k));
+        float radius = std::sqrt((b - zc) * (b - zc) + k * b * b);
+        glm::vec3 center = glm::vec3(invView * glm::vec4(0.0f, 0.0f, -zc, 1.0f));
+
+        // Follow the camera in coarse steps: between steps the cascade's
+        // matrices are bit-identical, which keeps its static layer cached.
+        // The radius grows by half a cell diagonal to keep covering the slice.
+        if (recenterFraction > 0.0f) {
+            float step = radius * recenterFraction;
+            center = glm::vec3(std::round(center.x / step) * step,
+                               std::round(center.y / step) * step,
+                               std::round(center.z / step) * step);
+            radius += step * 0.8660254f;
+        }
+
+        glm::vec3 lightPos = center - direction * (radius + kCasterDepth);
+        cascadeView[i] = glm::lookAt(lightPos, center, up);
+        cascadeProj[i] = glm::ortho(-radius, radius, -radius, radius, 0.0f, 2.0f * radius + kCasterDepth);
+
+        // Snap to texel grid to prevent shadow swimming
+        glm::mat4 shadowMat = cascadeProj[i] * cascadeView[i];
+        glm::vec4 origin = shadowMat * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+        origin.x *= (float)shadowWidth  * 0.5f;
+        origin.y *= (float)shadowHeight * 0.5f;
+        float rx = std::round(origin.x);
+        float ry = std::round(origin.y);
+        cascadeProj[i][3][0] += (rx - origin.x) * 2.0f / (float)shadowWidth;
+        cascadeProj[i][3][1] += (ry - origin.y) * 2.0f / (float)shadowHeight;
+    }
+}
+
+// Casters are culled against each cascade's light volume without its near
+// plane: anything between the light and the cascade still throws a shadow
+// into it, and depth clamping flattens it onto the near plane.
+static constexpr unsigned kCasterPlanes = Frustum::kAllPlanes & ~Frustum::kNearPlane;
+
+void LightComponent::gatherCasters(Scene* scene)
+{
+    staticCasters.clear();
+    dynamicCasters.clear();
+
+    Frustum volumes[kMaxCascades];
+    for (int c = 0; c < cascadeCount; ++c)
+        volumes[c].Extract(GetCascadeVP(c));
+
     const auto& objects = scene->GetObjects();
     for (auto* obj : objects) {
-        auto* cam = obj->GetComponent<CameraComponent>();
-        if (cam) {
-            Vector3 p = obj->GetPosition3D();
-            center = glm::vec3(p.x, p.y, p.z);
-            break;
+        if (!obj->IsActive()) continue;
+        auto* modelComp = obj->GetComponent<Model3DComponent>();
+        if (!modelComp) continue;
+        Caster caster{obj, modelComp, glm::vec3(0.0f), glm::vec3(0.0f), 0u};
+        modelComp->GetWorldBounds(caster.boundsMin, caster.boundsMax);
+        for (int c = 0; c < cascadeCount; ++c) {
+            if (volumes[c].TestAABB(caster.boundsMin, caster.boundsMax, kCasterPlanes))
+                caster.cascadeMask |= 1u << c;
         }
+        if (!caster.cascadeMask) {
+            shadowStats.castersCulled++;
+            continue;
+        }
+        (obj->IsStatic() ? staticCasters : dynamicCasters).push_back(caster);
     }
+}
 
-    shadowCenter = center;
-    const float range = 25.0f;
-    shadowRangeSq = range * range;
+// Draw the casters that touch `cascade`; `patch` further restricts them to a
+// scissored sub-region of the layer.
+void LightComponent::drawCasters(const std::vector<Caster>& casters, int cascade, const Frustum* patch)
+{
+    ModelBatch& batch = ModelBatch::Get();
+    for (const auto& c : casters) {
+        if (!(c.cascadeMask & (1u << cascade))) continue;
+        if (patch && !patch->TestAABB(c.boundsMin, c.boundsMax, kCasterPlanes)) continue;
+        batch.Add(c.model);
+        shadowStats.casterDraws++;
+    }
+    if (batch.Empty()) return;
+    batch.FlushDepth(GetCascadeVP(cascade));
+    GLuint prog = depthProgram;
+    RecordGL([prog] { GLState::Get().UseProgram(prog); });   // chunks and later casters use the plain depth program
+}
 
-    glm::vec3 up = (std::abs(direction.y) > 0.99f) ? glm::vec3(0, 0, 1) : glm::vec3(0, 1, 0);
-    glm::vec3 lightPos = center - direction * (range * 2.0f);
-    lightView = glm::lookAt(lightPos, center, up);
-    lightProj = glm::ortho(-range, range, -range, range, 0.1f, range * 4.0f);
+void LightComponent::drawStaticCasters(int cascade, const glm::mat4& lightVP, const Frustum& frustum, bool patch)
+{
+    drawCasters(staticCasters, cascade, patch ? &frustum : nullptr);
+    if (IVoxelRenderer::s_instance)
+        IVoxelRenderer::s_instance->RenderChunksDepth(depthProgram, lightVP, frustum, cascade);
+}
 
-    // Snap to texel grid to prevent shadow swimming
-    glm::mat4 shadowMat = lightProj * lightView;
-    glm::vec4 origin = shadowMat * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
-    origin.x *= (float)shadowWidth  * 0.5f;
-    origin.y *= (float)shadowHeight * 0.5f;
-    float rx = std::round(origin.x);
-    float ry = std::round(origin.y);
-    lightProj[3][0] += (rx - origin.x) * 2.0f / (float)shadowWidth;
-    lightProj[3][1] += (ry - origin.y) * 2.0f / (float)shadowHeight;
+// Re-render the parts of a static cascade layer covered by changed chunk
+// bounds.  Each region is scissored to its texel rectangle and culled with a
+// frustum cropped to it.  Returns true if anything was drawn.
+bool LightComponent::renderStaticPatches(int cascade, const glm::mat4& lightVP)
+{
+    struct Rect { float x0, y0, x1, y1; };   // light NDC
+    std::vector<Rect> rects;
+    for (const auto& b : changedBounds) {
+        Rect r{1.0f, 1.0f, -1.0f, -1.0f};
+        for (int i = 0; i < 8; ++i) {
+            glm::vec4 p = lightVP * glm::vec4((i & 1) ? b.max.x : b.min.x,
+                                              (i & 2) ? b.max.y : b.min.y,
+                                              (i & 4) ? b.max.z : b.min.z, 1.0f);
+            r.x0 = std::min(r.x0, p.x); r.x1 = std::max(r.x1, p.x);
+            r.y0 = std::min(r.y0, p.y); r.y1 = std::max(r.y1, p.y);
+        }
+        r.x0 = std::max(r.x0, -1.0f); r.y0 = std::max(r.y0, -1.0f);
+        r.x1 = std::min(r.x1,  1.0f); r.y1 = std::min(r.y1,  1.0f);
+        if (r.x0 < r.x1 && r.y0 < r.y1) rects.push_back(r);   // else outside this cascade
+    }
+    if (rects.empty()) return false;
+    if ((int)rects.size() > kMaxShadowPatches) {
+        Rect u = rects[0];
+        for (const auto& r : rects) {
+            u.x0 = std::min(u.x0, r.x0); u.y0 = std::min(u.y0, r.y0);
+            u.x1 = std::max(u.x1, r.x1); u.y1 = std::max(u.y1, r.y1);
+        }
+        rects.assign(1, u);
+    }
+
+    RecordGL([] { GLState::Get().SetEnabled(GL_SCISSOR_TEST, true); });
+    for (const auto& r : rects) {
+        // Texel rectangle, padded by a texel for rasterisation rounding
+        int x0 = std::max(0, (int)std::floor((r.x0 * 0.5f + 0.5f) * shadowWidth) - 1);
+        int y0 = std::max(0, (int)std::floor((r.y0 * 0.5f + 0.5f) * shadowHeight) - 1);
+        int x1 = std::min(shadowWidth,  (int)std::ceil((r.x1 * 0.5f + 0.5f) * shadowWidth) + 1);
+        int y1 = std::min(shadowHeight, (int)std::ceil((r.y1 * 0.5f + 0.5f) * shadowHeight) + 1);
+        RecordGL([x0, y0, x1, y1] {
+            glScissor(x0, y0, x1 - x0, y1 - y0);
+            glClear(GL_DEPTH_BUFFER_BIT);
+        });
+
+        // Crop matrix mapping the (padded) rectangle onto the full NDC square
+        float nx0 = x0 * 2.0f / shadowWidth - 1.0f,  nx1 = x1 * 2.0f / shadowWidth - 1.0f;
+        float ny0 = y0 * 2.0f / shadowHeight - 1.0f, ny1 = y1 * 2.0f / shadowHeight - 1.0f;
+        glm::mat4 crop(1.0f);
+        crop[0][0] = 2.0f / (nx1 - nx0);
+        crop[1][1] = 2.0f / (ny1 - ny0);
+        crop[3][0] = -(nx0 + nx1) / (nx1 - nx0);
+        crop[3][1] = -(ny0 + ny1) / (ny1 - ny0);
+        Frustum patchFrustum;
+        patchFrustum.Extract(crop * lightVP);
+        drawStaticCasters(cascade, lightVP, patchFrustum, true);
+    }
+    RecordGL([] { GLState::Get().SetEnabled(GL_SCISSOR_TEST, false); });
+    return true;
 }
 
 void LightComponent::RenderShadowMap(Scene* scene)
@@ -139,49 +325,109 @@ void LightComponent::RenderShadowMap(Scene* scene)
     if (!enableShadows || !scene) return;
     ensureShadowResources();
     computeLightMatrices(scene);
+    gatherCasters(scene);
 
-    glViewport(0,0,shadowWidth,shadowHeight);
-    glBindFramebuffer(GL_FRAMEBUFFER, depthFBO);
-    glEnable(GL_DEPTH_TEST);
-    glClear(GL_DEPTH_BUFFER_BIT);
-
-    glUseProgram(depthProgram);
-    static std::unordered_map<GLuint, GLint> depthLightVPLocCache;
-    GLint lightVPLoc;
-    auto it = depthLightVPLocCache.find(depthProgram);
-    if (it == depthLightVPLocCache.end()) {
-        lightVPLoc = glGetUniformLocation(depthProgram, "lightVP");
-        depthLightVPLocCache[depthProgram] = lightVPLoc;
-    } else {
-        lightVPLoc = it->second;
-    }
-    glm::mat4 lightVP = GetLightVP();
-    glUniformMatrix4fv(lightVPLoc, 1, GL_FALSE, glm::value_ptr(lightVP));
+    // Always drain the change list so it never describes stale geometry.
+    changedBounds.clear();
+    bool worldReset = IVoxelRenderer::s_instance && IVoxelRenderer::s_instance->TakeChangedBounds(changedBounds);
 
-    const auto& objects = scene->GetObjects();
-    for (auto* obj : objects) {
-        if (!obj->IsActive()) continue;
-        auto* modelComp = obj->GetComponent<Model3DComponent>();
-        if (!modelComp) continue;
-        // Distance culling — skip objects far from camera
-        Vector3 p = obj->GetPosition3D();
-        float dx = p.x - shadowCenter.x;
-        float dz = p.z - shadowCenter.z;
-        if (dx*dx + dz*dz > shadowRangeSq) continue;
-        glm::mat4 model = modelComp->ComputeModelMatrix();
-        modelComp->RenderDepthPass(model, depthProgram);
+    // Static objects can't move, but they can appear, vanish or be moved by
+    // hand; hash what each cascade covers, so such a change rebuilds only
+    // the layers it touches.
+    size_t casterHash[kMaxCascades];
+    for (int c = 0; c < cascadeCount; ++c) casterHash[c] = 0;
+    for (const auto& c : staticCasters) {
+        size_t h = std::hash<const void*>()(c.object);
+        for (int i = 0; i < 3; ++i)
+            h = h * 31 ^ std::hash<float>()(c.boundsMin[i]) ^ (std::hash<float>()(c.boundsMax[i]) << 1);
+        for (int k = 0; k < cascadeCount; ++k)
+            if (c.cascadeMask & (1u << k))
+                casterHash[k] = casterHash[k] * 1099511628211ull ^ h;
     }
+    bool rebuildAll = !staticValid || worldReset;
+    staticValid = true;
+
+    // Culling and caching decisions happen here; the GL work is recorded
+    // with the values it needs.
+    const GLuint prog = depthProgram;
+    const int width = shadowWidth, height = shadowHeight;
+    const GLuint staticFbo = staticFBO, staticTex = staticDepthTexture;
+    const GLuint dynamicFbo = depthFBO, dynamicTex = depthTexture;
+
+    GpuProfiler::Scope gpu(GpuProfiler::PassShadow);
+    bool began = false;
+    for (int c = 0; c < cascadeCount; ++c) {
+        glm::mat4 lightVP = GetCascadeVP(c);
+        Frustum cascadeFrustum;
+        cascadeFrustum.Extract(lightVP);
 
-    // Batch-rendered voxel chunks — frustum-culled against light ortho box
-    if (IVoxelRenderer::s_instance) {
-        Frustum lightFrustum;
-        lightFrustum.Extract(lightVP);
-        IVoxelRenderer::s_instance->RenderChunksDepth(depthProgram, lightVP, lightFrustum);
+        bool fullStatic = rebuildAll || casterHash[c] != staticCasterHash[c] || lightVP != staticLightVP[c];
+        bool hasDynamic = false;
+        for (const auto& d : dynamicCasters)
+            if (d.cascadeMask & (1u << c)) { hasDynamic = true; break; }
+
+        // Nothing moved and nothing dynamic to draw: this layer is current.
+        if (!fullStatic && changedBounds.empty() && !hasDynamic && !hadDynamicCasters[c])
+            continue;
+
+        if (!began) {
+            RecordGL([width, height] {
+                GLState& state = GLState::Get();
+                state.Viewport(0, 0, width, height);
+                state.SetEnabled(GL_DEPTH_TEST, true);
+                state.SetEnabled(GL_DEPTH_CLAMP, true);   // casters in front of the near plane land at depth 0
+            });
+            began = true;
+        }
+
+        // ── Static layer ─────────────────────────────────────────────
+        bool staticChanged = false;
+        RecordGL([prog, lightVP, staticFbo, staticTex, c, fullStatic] {
+            GLState::Get().UseProgram(prog);
+            setLightVP(prog, lightVP);
+            GLState::Get().BindFramebuffer(GL_FRAMEBUFFER, staticFbo);
+            glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, staticTex, 0, c);
+            if (fullStatic) glClear(GL_DEPTH_BUFFER_BIT);
+        });
+        if (fullStatic) {
+            drawStaticCasters(c, lightVP, cascadeFrustum, false);
+            staticLightVP[c] = lightVP;
+            staticCasterHash[c] = casterHash[c];
+            staticChanged = true;
+            shadowStats.staticFullRenders++;
+        } else if (renderStaticPatches(c, lightVP)) {
+            staticChanged = true;
+            shadowStats.staticPatchRenders++;
+        }
+
+        // ── Compose: static copy + dynamic casters ───────────────────
+        if (staticChanged || hasDynamic || hadDynamicCasters[c]) {
+            RecordGL([dynamicFbo, dynamicTex, staticFbo, width, height, c] {
+                GLState& state = GLState::Get();
+                state.BindFramebuffer(GL_FRAMEBUFFER, dynamicFbo);
+                glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, dynamicTex, 0, c);
+                state.BindFramebuffer(GL_READ_FRAMEBUFFER, staticFbo);
+                glBlitFramebuffer(0, 0, width, height, 0, 0, width, height,
+                                  GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+                state.BindFramebuffer(GL_FRAMEBUFFER, dynamicFbo);
+            });
+            drawCasters(dynamicCasters, c, nullptr);
+            if (hasDynamic) shadowStats.dynamicRenders++;
+        }
+        hadDynamicCasters[c] = hasDynamic;
     }
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glUseProgram(0);
-    glViewport(0, 0, Renderer::Get().GetWindowWidth(), Renderer::Get().GetWindowHeight());
+    if (!began) {
+        shadowStats.skippedFrames++;
+        return;
+    }
+    int windowWidth = Renderer::Get().GetWindowWidth(), windowHeight = Renderer::Get().GetWindowHeight();
+    RecordGL([windowWidth, windowHeight] {
+        GLState& state = GLState::Get();
+        state.SetEnabled(GL_DEPTH_CLAMP, false);
+        state.BindFramebuffer(GL_FRAMEBUFFER, 0);
+        state.Viewport(0, 0, windowWidth, windowHeight);
+    });
 }
 
 LightComponent* LightComponent::FindActive(Scene* scene)
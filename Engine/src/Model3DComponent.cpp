@@ -2,69 +2,123 @@
 #include "object.h"
 #include "ResourceManager.h"
 #include "LightComponent.h"
+#include "FrameUniforms.h"
+#include "RenderThread.h"
+#include "ShaderFeatures.h"
+#include "GLState.h"
+#include <glm/gtc/matrix_inverse.hpp>
 #include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
 #include <SDL.h>
 #include <iostream>
+#include <string>
+#include <unordered_map>
 
 // ==================== Shaders (Lambert lighting + basic shadows) ====================
-static const char* vertexShaderSource = R"(
-#version 330 core
-
+// One source for every "model3d" variant; ShaderFeatures picks the #defines.
+// INSTANCED takes the model matrix, normal matrix and tint from per-instance
+// attributes, SHADOWS / SHADOW_TAPS compile in the cascaded shadow lookup and
+// HIGHLIGHT the tint.  Normal matrices are computed on the CPU.
+static const char* vertexShaderBody = R"(
 layout(location = 0) in vec3 aPos;       // Vertex position
 layout(location = 1) in vec2 aTexCoord;  // UV
 layout(location = 2) in vec3 aNormal;    // Normal
 
+#ifdef INSTANCED
+layout(location = 3) in mat4 aModel;         // per instance (locations 3-6)
+layout(location = 7) in vec4 aTint;          // per instance highlight tint
+layout(location = 8) in mat3 aNormalMatrix;  // per instance (locations 8-10)
+#else
+uniform mat4 model;
+uniform mat3 normalMatrix;  // inverse transpose of the model matrix's 3x3
+uniform vec4 highlightTint; // rgb=tint color, a=mix factor
+#endif
+
 out vec2 TexCoord;
 out vec3 Normal;     
 out vec3 FragPos;
-out vec4 LightSpacePos;
-
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-uniform mat4 lightVP;
+out float ViewDepth;
+#ifdef HIGHLIGHT
+flat out vec4 Tint;
+#endif
 
 void main()
 {
+#ifdef INSTANCED
+    mat4 model = aModel;
+    mat3 normalMatrix = aNormalMatrix;
+#endif
+#ifdef HIGHLIGHT
+#ifdef INSTANCED
+    Tint = aTint;
+#else
+    Tint = highlightTint;
+#endif
+#endif
     // Vertex position in world coordinates
     vec4 worldPos = model * vec4(aPos, 1.0);
-    gl_Position   = projection * view * worldPos;
+    vec4 viewPos  = view * worldPos;
+    gl_Position   = projection * viewPos;
+    ViewDepth     = -viewPos.z;   // picks the shadow cascade
 
     // Pass to fragment shader
     FragPos  = worldPos.xyz;
     TexCoord = aTexCoord;
 
     // Normal transform (accounts for scale/rotation)
-    mat3 normalMatrix = mat3(transpose(inverse(model)));
     Normal = normalize(normalMatrix * aNormal);
-
-    LightSpacePos = lightVP * worldPos;
 }
 )";
 
-static const char* fragmentShaderSource = R"(
-#version 330 core
+static const std::string vertexShaderSource =
+    std::string("#version 330 core\n") + FrameUniforms::kBlockSource + vertexShaderBody;
+
+// Camera, light and cascade data come from the FrameData block
+static const char* fragmentShaderBody = R"(
 out vec4 FragColor;
 
 in vec2 TexCoord;
 in vec3 Normal;
 in vec3 FragPos;
-in vec4 LightSpacePos;
+in float ViewDepth;
+#ifdef HIGHLIGHT
+flat in vec4 Tint;          // rgb=tint color, a=mix factor
+#endif
 
 // Textures
 uniform sampler2D ourTexture;
-uniform sampler2D shadowMap;
 
-// Light parameters
-uniform vec3 lightDir;      // light direction (world)
-uniform vec3 lightColor;    // light color
-uniform vec3 ambientColor;  // ambient color
-uniform int useShadows;     // 0/1
-uniform vec4 highlightTint; // rgb=tint color, a=mix factor (0=no tint)
-
-float ShadowCalculation(vec4 lightSpacePos, vec3 normal, vec3 lightDirection)
+#ifdef SHADOWS
+#ifndef SHADOW_TAPS
+#define SHADOW_TAPS 1
+#endif
+uniform sampler2DArrayShadow shadowMap;   // one layer per cascade, depth compare enabled
+
+// 16-tap Poisson disk, ordered so that the first 4 and first 9 taps are
+// each evenly spread (lower quality tiers use a prefix)
+const vec2 poissonDisk[16] = vec2[](
+    vec2(-0.26496911, -0.41893023), vec2( 0.53742981, -0.47373420),
+    vec2(-0.38277543,  0.27676845), vec2( 0.34495938,  0.29387760),
+    vec2(-0.94201624, -0.39906216), vec2( 0.94558609, -0.76890725),
+    vec2(-0.91588581,  0.45771432), vec2( 0.97484398,  0.75648379),
+    vec2( 0.14383161, -0.14100790), vec2(-0.09418410, -0.92938870),
+    vec2(-0.81544232, -0.87912464), vec2( 0.44323325, -0.97511554),
+    vec2( 0.79197514,  0.19090188), vec2(-0.24188840,  0.99706507),
+    vec2(-0.81409955,  0.91437590), vec2( 0.19984126,  0.78641367)
+);
+
+float ShadowCalculation(vec3 worldPos, float viewDepth, vec3 normal, vec3 lightDirection)
 {
+    int cascadeCount = shadowParams.y;
+    float lastSplit = cascadeSplits[cascadeCount - 1];
+    if (viewDepth > lastSplit)
+        return 0.0;
+
+    // First cascade whose range contains this fragment
+    int cascade = 0;
+    while (cascade < cascadeCount - 1 && viewDepth > cascadeSplits[cascade])
+        ++cascade;
+
+    vec4 lightSpacePos = lightVPs[cascade] * vec4(worldPos, 1.0);
     vec3 projCoords = lightSpacePos.xyz / lightSpacePos.w;
     projCoords = projCoords * 0.5 + 0.5;
 
@@ -75,52 +129,55 @@ float ShadowCalculation(vec4 lightSpacePos, vec3 normal, vec3 lightDirection)
 
     // Slope-scaled bias: small values to keep shadow close to geometry
     float cosTheta = max(dot(normalize(normal), -normalize(lightDirection)), 0.0);
-    float bias = mix(0.002, 0.0004, cosTheta);
-
-    // 5x5 PCF for softer shadow edges
-    float shadow = 0.0;
-    vec2 texelSize = 1.0 / textureSize(shadowMap, 0);
-    int samples = 0;
-    for (int x = -2; x <= 2; ++x) {
-        for (int y = -2; y <= 2; ++y) {
-            float pcfDepth = texture(shadowMap, projCoords.xy + vec2(x, y) * texelSize).r;
-            shadow += (currentDepth - bias) > pcfDepth ? 1.0 : 0.0;
-            samples++;
-        }
-    }
-    shadow /= float(samples);
-
-    // Fade shadow near shadow-map borders to avoid hard cutoff
-    float fadeRange = 0.05;
-    float fadeFactor = 1.0;
-    fadeFactor *= smoothstep(0.0, fadeRange, projCoords.x);
-    fadeFactor *= smoothstep(0.0, fadeRange, 1.0 - projCoords.x);
-    fadeFactor *= smoothstep(0.0, fadeRange, projCoords.y);
-    fadeFactor *= smoothstep(0.0, fadeRange, 1.0 - projCoords.y);
-    shadow *= fadeFactor;
+    // Farther cascades cover more world per texel and need more bias
+    float bias = mix(0.002, 0.0004, cosTheta) * (1.0 + float(cascade));
+
+    // Poisson-disk PCF. Each tap is a hardware depth comparison, which the
+    // driver filters bilinearly over 2x2 texels, so few taps stay smooth.
+    float reference = currentDepth - bias;
+#if SHADOW_TAPS <= 1
+    float lit = texture(shadowMap, vec4(projCoords.xy, float(cascade), reference));
+#else
+    float lit = 0.0;
+    vec2 filterRadius = 1.5 / vec2(textureSize(shadowMap, 0).xy);
+    for (int i = 0; i < SHADOW_TAPS; ++i)
+        lit += texture(shadowMap, vec4(projCoords.xy + poissonDisk[i] * filterRadius, float(cascade), reference));
+    lit /= float(SHADOW_TAPS);
+#endif
+    float shadow = 1.0 - lit;
+
+    // Fade out over the last 10% of the shadow distance to avoid a hard cutoff
+    shadow *= 1.0 - smoothstep(lastSplit * 0.9, lastSplit, viewDepth);
 
     return shadow;
 }
+#endif
 
 void main()
 {
     vec3 texColor = texture(ourTexture, TexCoord).rgb;
     vec3 norm = normalize(Normal);
-    float diff = max(dot(norm, -lightDir), 0.0);
-    vec3 diffuse = diff * lightColor;
-    vec3 ambient = ambientColor;
+    float diff = max(dot(norm, -lightDir.xyz), 0.0);
+    vec3 diffuse = diff * lightColor.rgb;
+    vec3 ambient = ambientColor.rgb;
 
+#ifdef SHADOWS
+    float shadow = ShadowCalculation(FragPos, ViewDepth, norm, lightDir.xyz);
+#else
     float shadow = 0.0;
-    if (useShadows == 1) {
-        shadow = ShadowCalculation(LightSpacePos, norm, lightDir);
-    }
+#endif
 
     vec3 result = texColor * (ambient + (1.0 - shadow) * diffuse);
-    result = mix(result, highlightTint.rgb, highlightTint.a);
+#ifdef HIGHLIGHT
+    result = mix(result, Tint.rgb, Tint.a);
+#endif
     FragColor   = vec4(result, 1.0);
 }
 )";
 
+static const std::string fragmentShaderSource =
+    std::string("#version 330 core\n") + FrameUniforms::kBlockSource + fragmentShaderBody;
+
 // ==================== Constructor/Destructor ====================
 Model3DComponent::Model3DComponent(const std::string& modelPath)
     : modelPath(modelPath)
@@ -145,6 +202,7 @@ void Model3DComponent::Init()
     aabbMax = sharedMesh->aabbMax;
     aabbComputed = true;
     modelDims = aabbMax - aabbMin;
+    worldCacheValid = false;
 
     // If the owning object has no size set, initialise it from the model's natural size
     if (object && object->GetSize3D().x == 0 && object->GetSize3D().y == 0 && object->GetSize3D().z == 0) {
@@ -154,11 +212,13 @@ void Model3DComponent::Init()
 
 glm::mat4 Model3DComponent::ComputeModelMatrix() const
 {
-    Vector3 p = object->GetPosition3D();
-    glm::vec3 position(p.x, p.y, p.z);
-    Vector3 angle = object->GetAngle();
+    // Object world matrix (position, rotation, parents) times the fit of
+    // the imported mesh to the object's size
+    return object->GetWorldMatrix() * computeLocalMatrix();
+}
 
-    glm::mat4 model = glm::mat4(1.0f);
+glm::mat4 Model3DComponent::computeLocalMatrix() const
+{
     glm::mat4 local = glm::mat4(1.0f);
 
     Vector3 targetSize = object->GetSize3D();
@@ -173,9 +233,6 @@ glm::mat4 Model3DComponent::ComputeModelMatrix() const
     if (aabbComputed) {
         glm::vec3 dims = aabbMax - aabbMin;
         glm::vec3 center = (aabbMin + aabbMax) * 0.5f;
-        if (modelDims == glm::vec3(0.0f)) {
-            // const_cast is safe-ish here to initialize cache; but avoid mutating.
-        }
         float sx = dims.x != 0.0f ? targetSize.x / dims.x : 1.0f;
         float sy = dims.y != 0.0f ? targetSize.y / dims.y : 1.0f;
         float sz = dims.z != 0.0f ? targetSize.z / dims.z : 1.0f;
@@ -185,36 +242,98 @@ glm::mat4 Model3DComponent::ComputeModelMatrix() const
     } else {
         local = glm::scale(local, glm::vec3(targetSize.x, targetSize.y, targetSize.z));
     }
+    return local;
+}
+
+// Keyed on the object's world version, which changes only when the object
+// (or an ancestor) moved, rotated or was resized: static models never
+// rebuild their matrix or bounds.
+void Model3DComponent::updateWorldCache() const
+{
+    uint32_t version = object->GetWorldVersion();
+    if (worldCacheValid && version == cachedWorldVersion)
+        return;
+    cachedWorldVersion = version;
+    worldCacheValid = true;
+    worldMatrix = ComputeModelMatrix();
+    worldNormalMatrix = glm::inverseTranspose(glm::mat3(worldMatrix));
+
+    if (!aabbComputed) {
+        // Unknown extent: same 2-unit radius the culling code used before
+        glm::vec3 c(worldMatrix[3]);
+        worldMin = c - glm::vec3(2.0f);
+        worldMax = c + glm::vec3(2.0f);
+        return;
+    }
+    // Transformed box extents: |M| applied to the half size (Arvo's method)
+    glm::vec3 localCenter = (aabbMin + aabbMax) * 0.5f;
+    glm::vec3 localHalf = (aabbMax - aabbMin) * 0.5f;
+    glm::vec3 center = glm::vec3(worldMatrix * glm::vec4(localCenter, 1.0f));
+    glm::vec3 half(0.0f);
+    for (int col = 0; col < 3; ++col)
+        half += glm::abs(glm::vec3(worldMatrix[col])) * localHalf[col];
+    worldMin = center - half;
+    worldMax = center + half;
+}
+
+const glm::mat4& Model3DComponent::GetWorldMatrix() const
+{
+    updateWorldCache();
+    return worldMatrix;
+}
+
+glm::mat4 Model3DComponent::GetRenderMatrix() const
+{
+    if (!object->IsRenderInterpolated())
+        return GetWorldMatrix();
+    return object->GetRenderMatrix() * computeLocalMatrix();
+}
+
+void Model3DComponent::GetRenderTransform(glm::mat4& model, glm::mat3& normalMatrix) const
+{
+    if (!object->IsRenderInterpolated()) {
+        updateWorldCache();
+        model = worldMatrix;
+        normalMatrix = worldNormalMatrix;
+        return;
+    }
+    model = GetRenderMatrix();
+    normalMatrix = glm::inverseTranspose(glm::mat3(model));
+}
 
-    model = glm::translate(model, position);
-    model = glm::rotate(model, glm::radians(angle.x), glm::vec3(1, 0, 0));
-    model = glm::rotate(model, glm::radians(angle.y), glm::vec3(0, 1, 0));
-    model = glm::rotate(model, glm::radians(angle.z), glm::vec3(0, 0, 1));
-    model = model * local;
-    return model;
+void Model3DComponent::GetWorldBounds(glm::vec3& mn, glm::vec3& mx) const
+{
+    updateWorldCache();
+    mn = worldMin;
+    mx = worldMax;
 }
 
 void Model3DComponent::RenderDepthPass(const glm::mat4& model, GLuint depthProgram) const
 {
     if (!sharedMesh) return;
-    
-    static std::unordered_map<GLuint, GLint> depthModelLocCache;
-    GLint modelLoc;
-    auto it = depthModelLocCache.find(depthProgram);
-    if (it == depthModelLocCache.end()) {
-        modelLoc = glGetUniformLocation(depthProgram, "model");
-        depthModelLocCache[depthProgram] = modelLoc;
-    } else {
-        modelLoc = it->second;
-    }
-    
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
 
-    for (const auto& mesh : sharedMesh->meshes) {
-        glBindVertexArray(mesh.VAO);
-        glDrawElements(GL_TRIANGLES, mesh.numIndices, GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
-    }
+    // Shared meshes live until ResourceManager::ReleaseAll, which drains
+    // the render thread first, so the command can keep the pointer.
+    const SharedMeshData* meshData = sharedMesh;
+    RecordGL([meshData, model, depthProgram] {
+        static std::unordered_map<GLuint, GLint> depthModelLocCache;
+        GLint modelLoc;
+        auto it = depthModelLocCache.find(depthProgram);
+        if (it == depthModelLocCache.end()) {
+            modelLoc = glGetUniformLocation(depthProgram, "model");
+            depthModelLocCache[depthProgram] = modelLoc;
+        } else {
+            modelLoc = it->second;
+        }
+
+        GLState& state = GLState::Get();
+        state.SetUniform(modelLoc, model);
+
+        for (const auto& mesh : meshData->meshes) {
+            state.BindVertexArray(mesh.VAO);
+            glDrawElements(GL_TRIANGLES, mesh.numIndices, GL_UNSIGNED_INT, 0);
+        }
+    });
 }
 
 bool Model3DComponent::SetAlbedoTextureFromFile(const std::string& fullPath)
@@ -225,104 +344,120 @@ bool Model3DComponent::SetAlbedoTextureFromFile(const std::string& fullPath)
     return true;
 }
 
-// Returns a 1×1 white texture used as a fallback when no shadow map is available.
-// This prevents the GPU driver from warning about an unbound sampler on unit 1.
-// We use GL_RED (not GL_DEPTH_COMPONENT) because macOS's OpenGL driver may reject
-// incomplete depth textures bound to a regular sampler2D.
+// Returns a 1×1 single-layer depth array texture (depth 1.0) used as a fallback when no
+// shadow map is available. This prevents the GPU driver from warning about an unbound
+// sampler on unit 1. It has to be a complete depth texture with comparison enabled,
+// since sampler2DArrayShadow is undefined for colour formats (macOS rejects the draw).
 static GLuint getDummyShadowMap() {
     static GLuint dummy = 0;
-    if (dummy == 0) {
-        glGenTextures(1, &dummy);
-        glBindTexture(GL_TEXTURE_2D, dummy);
-        unsigned char white = 255;
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, 1, 1, 0, GL_RED, GL_UNSIGNED_BYTE, &white);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glBindTexture(GL_TEXTURE_2D, 0);
+    if (dummy == 0 && !RenderThread::Get().IsNullBackend()) {
+        dummy = RenderThread::Get().AllocateName(RenderThread::NameTexture);
+        RecordGL([dummy = dummy] {
+            GLState::Get().BindTexture(1, GL_TEXTURE_2D_ARRAY, dummy);
+            float farDepth = 1.0f;
+            glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, 1, 1, 1, 0, GL_DEPTH_COMPONENT, GL_FLOAT, &farDepth);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+        });
     }
     return dummy;
 }
 
-// ==================== Render: called by RenderSystem ==========================
-void Model3DComponent::Render(const glm::mat4& view, const glm::mat4& projection, LightComponent* light)
-{
-    glm::mat4 model = ComputeModelMatrix();
+// ==================== Shared lighting setup ==========================
+namespace {
+struct LitUniforms {
+    GLint model, normalMatrix, shadowMap, highlightTint, ourTexture;
+};
 
-    GLuint prog = ResourceManager::Get().GetOrCreateShader("model3d", vertexShaderSource, fragmentShaderSource);
-    glUseProgram(prog);
-
-    struct Uniforms {
-        GLint model, view, proj, shadowMap, lightDir, lightColor, ambientColor, lightVP, useShadows, highlightTint, ourTexture;
-    };
-    static std::unordered_map<GLuint, Uniforms> uniformCache;
-    
+const LitUniforms& litUniforms(GLuint prog)
+{
+    static std::unordered_map<GLuint, LitUniforms> uniformCache;
     auto it = uniformCache.find(prog);
     if (it == uniformCache.end()) {
-        Uniforms u;
+        LitUniforms u;
         u.model = glGetUniformLocation(prog, "model");
-        u.view  = glGetUniformLocation(prog, "view");
-        u.proj  = glGetUniformLocation(prog, "projection");
+        u.normalMatrix = glGetUniformLocation(prog, "normalMatrix");
         u.shadowMap = glGetUniformLocation(prog, "shadowMap");
-        u.lightDir = glGetUniformLocation(prog, "lightDir");
-        u.lightColor = glGetUniformLocation(prog, "lightColor");
-        u.ambientColor = glGetUniformLocation(prog, "ambientColor");
-        u.lightVP = glGetUniformLocation(prog, "lightVP");
-        u.useShadows = glGetUniformLocation(prog, "useShadows");
         u.highlightTint = glGetUniformLocation(prog, "highlightTint");
         u.ourTexture = glGetUniformLocation(prog, "ourTexture");
-        uniformCache[prog] = u;
-        it = uniformCache.find(prog);
-    }
-    const Uniforms& u = it->second;
-
-    // Upload matrices
-    glUniformMatrix4fv(u.model, 1, GL_FALSE, glm::value_ptr(model));
-    glUniformMatrix4fv(u.view,  1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(u.proj,  1, GL_FALSE, glm::value_ptr(projection));
-
-    // Lighting parameters
-    glm::vec3 lightDir(0.0f, 0.0f, -1.0f);
-    glm::vec3 lightColor(1.0f, 1.0f, 1.0f);
-    glm::vec3 ambientColor(0.2f, 0.2f, 0.2f);
-    glm::mat4 lightVP(1.0f);
-    int useShadows = 0;
-
-    if (light) {
-        lightDir = light->GetDirection();
-        lightColor = light->GetColor();
-        ambientColor = light->GetAmbient();
-        lightVP = light->GetLightVP();
-        useShadows = light->IsShadowEnabled() && (light->GetDepthTexture() != 0) ? 1 : 0;
+        it = uniformCache.emplace(prog, u).first;
     }
+    return it->second;
+}
+}
+
+void Model3DComponent::RegisterShaders()
+{
+    ResourceManager& rm = ResourceManager::Get();
+    rm.RegisterShaderVariants("model3d", vertexShaderSource.c_str(), fragmentShaderSource.c_str(),
+                              ShaderFeatures::Defines());
+    // What ModelBatch draws with a default light, with and without a
+    // highlighted model, and before the first shadow map exists
+    const uint32_t shadowed = ShaderFeatures::Instanced | ShaderFeatures::Shadows | ShaderFeatures::ShadowPcf9;
+    rm.PreloadShaderVariant("model3d", shadowed);
+    rm.PreloadShaderVariant("model3d", shadowed | ShaderFeatures::Highlight);
+    rm.PreloadShaderVariant("model3d", ShaderFeatures::Instanced);
+}
+
+GLuint Model3DComponent::GetLitProgram(uint32_t features)
+{
+    return ResourceManager::Get().GetShaderVariant("model3d", features);
+}
+
+GLuint Model3DComponent::GetShadowTexture(LightComponent* light)
+{
+    return (light && light->GetDepthTexture() != 0) ? light->GetDepthTexture() : getDummyShadowMap();
+}
+
+void Model3DComponent::BindLighting(GLuint prog, GLuint shadowTexture)
+{
+    const LitUniforms& u = litUniforms(prog);
+
+    // Always bind a valid texture to unit 1 so the sampler is never unbound
+    GLState& state = GLState::Get();
+    state.BindTexture(1, GL_TEXTURE_2D_ARRAY, shadowTexture);
+    state.SetUniform(u.shadowMap, 1);
+    state.SetUniform(u.ourTexture, 0);
+}
 
-    // Always bind a valid texture to unit 1 so the sampler is never unbound.
-    // Use the real shadow map when available, otherwise a 1×1 dummy depth texture.
-    GLuint shadowTex = (light && light->GetDepthTexture() != 0)
-                       ? light->GetDepthTexture()
-                       : getDummyShadowMap();
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, shadowTex);
-    glUniform1i(u.shadowMap, 1);
-
-    glUniform3fv(u.lightDir, 1, glm::value_ptr(lightDir));
-    glUniform3fv(u.lightColor, 1, glm::value_ptr(lightColor));
-    glUniform3fv(u.ambientColor, 1, glm::value_ptr(ambientColor));
-    glUniformMatrix4fv(u.lightVP, 1, GL_FALSE, glm::value_ptr(lightVP));
-    glUniform1i(u.useShadows, useShadows);
-    glUniform4fv(u.highlightTint, 1, glm::value_ptr(highlightTint));
-
-    // Bind albedo texture and draw each mesh
-    if (!sharedMesh) { glUseProgram(0); return; }
-    for (const auto& mesh : sharedMesh->meshes) {
-        GLuint albedoTex = overrideAlbedoTexture ? overrideAlbedoTexture : mesh.diffuseTexture;
-        if (albedoTex != 0) {
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, albedoTex);
-            glUniform1i(u.ourTexture, 0);
+void Model3DComponent::BindAlbedo(const SharedMeshEntry& mesh, GLuint overrideTexture)
+{
+    GLuint albedoTex = overrideTexture ? overrideTexture : mesh.diffuseTexture;
+    if (albedoTex != 0)
+        GLState::Get().BindTexture(0, GL_TEXTURE_2D, albedoTex);
+}
+
+// ==================== Render: single object ==========================
+void Model3DComponent::Render(LightComponent* light)
+{
+    if (!sharedMesh) return;
+    uint32_t features = ShaderFeatures::ForLight(light);
+    if (highlightTint.w > 0.0f) features |= ShaderFeatures::Highlight;
+    GLuint prog = GetLitProgram(features);
+    GLuint shadowTex = GetShadowTexture(light);
+    const SharedMeshData* meshData = sharedMesh;
+    glm::mat4 model;
+    glm::mat3 normalMatrix;
+    GetRenderTransform(model, normalMatrix);
+    glm::vec4 tint = highlightTint;
+    GLuint albedo = overrideAlbedoTexture;
+    RecordGL([prog, shadowTex, meshData, model, normalMatrix, tint, albedo] {
+        GLState& state = GLState::Get();
+        state.UseProgram(prog);
+        BindLighting(prog, shadowTex);
+
+        const LitUniforms& u = litUniforms(prog);
+        state.SetUniform(u.model, model);
+        state.SetUniform(u.normalMatrix, normalMatrix);
+        state.SetUniform(u.highlightTint, tint);
+
+        // Bind albedo texture and draw each mesh
+        for (const auto& mesh : meshData->meshes) {
+            BindAlbedo(mesh, albedo);
+            state.BindVertexArray(mesh.VAO);
+            glDrawElements(GL_TRIANGLES, mesh.numIndices, GL_UNSIGNED_INT, 0);
         }
-        glBindVertexArray(mesh.VAO);
-        glDrawElements(GL_TRIANGLES, mesh.numIndices, GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
-    }
-    glUseProgram(0);
+    });
 }
@@ -0,0 +1,175 @@
+#include "ModelBatch.h"
+#include "Model3DComponent.h"
+#include "ResourceManager.h"
+#include "RenderThread.h"
+#include "ShaderFeatures.h"
+#include "GLState.h"
+#include <cstddef>
+
+// Per-instance attribute locations (must match the instanced shaders)
+static constexpr GLuint kModelAttrib = 3;   // mat4: 3, 4, 5, 6
+static constexpr GLuint kTintAttrib  = 7;
+static constexpr GLuint kNormalAttrib = 8;  // mat3: 8, 9, 10
+
+static const char* depthVertexShaderSource = R"(
+#version 330 core
+layout(location=0) in vec3 aPos;
+layout(location=3) in mat4 aModel;
+uniform mat4 lightVP;
+void main(){
+    gl_Position = lightVP * aModel * vec4(aPos,1.0);
+}
+)";
+
+static const char* depthFragmentShaderSource = R"(
+#version 330 core
+void main(){ }
+)";
+
+ModelBatch& ModelBatch::Get() {
+    static ModelBatch instance;
+    return instance;
+}
+
+void ModelBatch::RegisterShaders()
+{
+    ResourceManager::Get().RegisterShader("model3d_depth_instanced", depthVertexShaderSource, depthFragmentShaderSource);
+}
+
+void ModelBatch::Add(const Model3DComponent* model)
+{
+    const SharedMeshData* mesh = model->GetSharedMesh();
+    if (!mesh) return;
+    GroupKey key{mesh, model->GetAlbedoOverride()};
+    auto it = m_groupIndex.find(key);
+    if (it == m_groupIndex.end()) {
+        it = m_groupIndex.emplace(key, (int)m_groups.size()).first;
+        m_groups.push_back(Group{key, {}});
+    }
+    Group& group = m_groups[it->second];
+    if (group.instances.empty()) m_active.push_back(it->second);
+    Instance instance;
+    model->GetRenderTransform(instance.model, instance.normal);
+    instance.tint = model->GetHighlightTint();
+    if (instance.tint.w > 0.0f) group.highlighted = true;
+    group.instances.push_back(instance);
+}
+
+void ModelBatch::FlushColor(LightComponent* light)
+{
+    if (m_active.empty()) return;
+    uint32_t features = ShaderFeatures::Instanced | ShaderFeatures::ForLight(light);
+    bool anyHighlighted = false;
+    for (int index : m_active)
+        anyHighlighted |= m_groups[index].highlighted;
+
+    LitPass lit;
+    lit.program = Model3DComponent::GetLitProgram(features);
+    lit.highlightProgram = anyHighlighted
+        ? Model3DComponent::GetLitProgram(features | ShaderFeatures::Highlight) : 0;
+    lit.shadowTexture = Model3DComponent::GetShadowTexture(light);
+    drawGroups(&lit);
+}
+
+void ModelBatch::FlushDepth(const glm::mat4& lightVP)
+{
+    if (m_active.empty()) return;
+    GLuint prog = ResourceManager::Get().GetShader("model3d_depth_instanced");
+    RecordGL([prog, lightVP] {
+        static std::unordered_map<GLuint, GLint> lightVPLocCache;
+        auto it = lightVPLocCache.find(prog);
+        if (it == lightVPLocCache.end())
+            it = lightVPLocCache.emplace(prog, glGetUniformLocation(prog, "lightVP")).first;
+        GLState::Get().UseProgram(prog);
+        GLState::Get().SetUniform(it->second, lightVP);
+    });
+    drawGroups(nullptr);
+}
+
+void ModelBatch::drawGroups(const LitPass* lit)
+{
+    if (!m_instanceVBO)
+        m_instanceVBO = RenderThread::Get().AllocateName(RenderThread::NameBuffer);
+
+    // The recorded command owns the instance data; the groups start the
+    // next flush empty.
+    std::vector<Group> frame;
+    frame.reserve(m_active.size());
+    for (int index : m_active) {
+        Group& group = m_groups[index];
+        size_t meshes = group.key.mesh->meshes.size();
+        m_stats.groups++;
+        m_stats.instances += (int)group.instances.size();
+        m_stats.drawCalls += (int)meshes;
+        frame.push_back(Group{group.key, std::move(group.instances), group.highlighted});
+        group.instances.clear();
+        group.highlighted = false;
+    }
+    m_active.clear();
+
+    GLuint vbo = m_instanceVBO;
+    bool bindAlbedo = lit != nullptr;
+    LitPass pass = lit ? *lit : LitPass{};
+    RecordGL([this, vbo, bindAlbedo, pass, frame = std::move(frame)] {
+        GLState& state = GLState::Get();
+        for (const Group& group : frame) {
+            GLsizei count = (GLsizei)group.instances.size();
+
+            // Lit variant for the group; unchanged program and lighting
+            // state is skipped by GLState
+            if (bindAlbedo) {
+                GLuint prog = group.highlighted && pass.highlightProgram ? pass.highlightProgram : pass.program;
+                state.UseProgram(prog);
+                Model3DComponent::BindLighting(prog, pass.shadowTexture);
+            }
+
+            // Orphan and refill: the driver hands back fresh storage if the
+            // previous group's draw is still in flight.
+            state.BindBuffer(GL_ARRAY_BUFFER, vbo);
+            glBufferData(GL_ARRAY_BUFFER, count * sizeof(Instance), group.instances.data(), GL_STREAM_DRAW);
+
+            for (const auto& mesh : group.key.mesh->meshes) {
+                if (bindAlbedo) Model3DComponent::BindAlbedo(mesh, group.key.albedo);
+                configureVAO(mesh.VAO, vbo);
+                state.BindVertexArray(mesh.VAO);
+                glDrawElementsInstanced(GL_TRIANGLES, mesh.numIndices, GL_UNSIGNED_INT, 0, count);
+            }
+        }
+    });
+}
+
+// Attach the instance buffer to a shared mesh VAO once.  The attribute
+// pointers reference the instance buffer by name, so refilling it needs no
+// rebind.  Runs inside recorded commands.
+void ModelBatch::configureVAO(GLuint vao, GLuint instanceVBO)
+{
+    if (!m_configuredVAOs.insert(vao).second) return;
+    GLState::Get().BindVertexArray(vao);
+    GLState::Get().BindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    for (GLuint i = 0; i < 4; ++i) {
+        glEnableVertexAttribArray(kModelAttrib + i);
+        glVertexAttribPointer(kModelAttrib + i, 4, GL_FLOAT, GL_FALSE, sizeof(Instance),
+                              (void*)(offsetof(Instance, model) + i * sizeof(glm::vec4)));
+        glVertexAttribDivisor(kModelAttrib + i, 1);
+    }
+    glEnableVertexAttribArray(kTintAttrib);
+    glVertexAttribPointer(kTintAttrib, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)offsetof(Instance, tint));
+    glVertexAttribDivisor(kTintAttrib, 1);
+    for (GLuint i = 0; i < 3; ++i) {
+        glEnableVertexAttribArray(kNormalAttrib + i);
+        glVertexAttribPointer(kNormalAttrib + i, 3, GL_FLOAT, GL_FALSE, sizeof(Instance),
+                              (void*)(offsetof(Instance, normal) + i * sizeof(glm::vec3)));
+        glVertexAttribDivisor(kNormalAttrib + i, 1);
+    }
+}
+
+void ModelBatch::Release()
+{
+    GLContextLock gl;
+    if (m_instanceVBO) glDeleteBuffers(1, &m_instanceVBO);
+    m_instanceVBO = 0;
+    m_configuredVAOs.clear();
+    m_groupIndex.clear();
+    m_groups.clear();
+    m_active.clear();
+}
@@ -0,0 +1,62 @@
+#include "RenderQueue.h"
+#include <algorithm>
+
+uint64_t RenderQueue::OpaqueKey(uint32_t shader, uint32_t texture, uint32_t mesh, float depth01)
+{
+    depth01 = std::min(std::max(depth01, 0.0f), 1.0f);
+    uint64_t depth = (uint64_t)(depth01 * (float)((1u << 22) - 1));
+    return ((uint64_t)PassOpaque << 62)
+         | ((uint64_t)(shader & 0xFF) << 54)
+         | ((uint64_t)(texture & 0xFFFF) << 38)
+         | ((uint64_t)(mesh & 0xFFFF) << 22)
+         | depth;
+}
+
+uint64_t RenderQueue::OverlayKey(Pass pass, int layer, uint32_t sequence)
+{
+    // Bias the signed layer so negative layers sort first
+    int biased = std::min(std::max(layer + 0x8000, 0), 0xFFFF);
+    return ((uint64_t)pass << 62)
+         | ((uint64_t)biased << 46)
+         | (uint64_t)(sequence & 0x3FFFFF);
+}
+
+uint32_t RenderQueue::MeshId(const void* mesh)
+{
+    auto it = m_meshIds.find(mesh);
+    if (it == m_meshIds.end())
+        it = m_meshIds.emplace(mesh, (uint32_t)m_meshIds.size() & 0xFFFF).first;
+    return it->second;
+}
+
+void RenderQueue::Sort()
+{
+    const size_t n = m_packets.size();
+    m_scratch.resize(n);
+
+    // One counting pass per key byte, least significant first.  Bytes every
+    // key shares (common: the pass bits, unused layers) are skipped.
+    for (int shift = 0; shift < 64; shift += 8) {
+        size_t count[256] = {};
+        for (const auto& p : m_packets) count[(p.key >> shift) & 0xFF]++;
+        if (n == 0 || count[(m_packets[0].key >> shift) & 0xFF] == n) continue;
+
+        size_t offset = 0;
+        for (size_t& c : count) { size_t t = c; c = offset; offset += t; }
+        for (const auto& p : m_packets) m_scratch[count[(p.key >> shift) & 0xFF]++] = p;
+        m_packets.swap(m_scratch);
+    }
+    countTransitions();
+}
+
+void RenderQueue::countTransitions()
+{
+    m_stats = Stats();
+    m_stats.packets = (int)m_packets.size();
+    uint32_t program = 0, texture = 0, vao = 0;
+    for (const auto& p : m_packets) {
+        if (p.program != program) { m_stats.programTransitions++; program = p.program; }
+        if (p.texture != texture) { m_stats.textureTransitions++; texture = p.texture; }
+        if (p.vao != vao)         { m_stats.vaoTransitions++;     vao = p.vao; }
+    }
+}
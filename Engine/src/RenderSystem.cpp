@@ -4,19 +4,31 @@
 #include "CameraComponent.h"
 #include "LightComponent.h"
 #include "Model3DComponent.h"
+#include "ModelBatch.h"
+#include "SpriteBatch.h"
+#include "RenderQueue.h"
+#include "FrameUniforms.h"
 #include "IVoxelRenderer.h"
 #include "Frustum.h"
 #include "image.h"
 #include "text.h"
 #include "Renderer.h"
+#include "RenderThread.h"
+#include "GLState.h"
+#include "GpuProfiler.h"
+#include "CpuProfiler.h"
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <optional>
+
+RenderQueue RenderSystem::s_queue;
 
 void RenderSystem::Render(Scene *scene)
 {
     if (!scene)
         return;
+    CpuProfiler::Scope zone("RenderSystem::Render");
 
     // ── 1. Find active camera ────────────────────────────────────────
     CameraComponent *cam = CameraComponent::FindActive(scene);
@@ -50,64 +62,164 @@ void RenderSystem::Render(Scene *scene)
     // ── 4. Shadow pass ───────────────────────────────────────────────
     if (light && light->IsShadowEnabled())
     {
+        CpuProfiler::Scope shadowZone("RenderSystem::ShadowPass");
         light->RenderShadowMap(scene);
     }
 
     // ── 5. Colour pass ───────────────────────────────────────────────
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    // Camera, light and cascade data for every 3D shader, uploaded once
+    FrameUniforms::Get().Update(view, projection, light);
+
+    // GL calls are recorded; culling and batching stay on this thread
+    RecordGL([] {
+        GLState::Get().SetEnabled(GL_BLEND, true);
+        GLState::Get().BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    });
 
     // ── 5a. Voxel chunks (3D, depth ON, frustum-culled per chunk) ────
     if (IVoxelRenderer::s_instance)
     {
-        glEnable(GL_DEPTH_TEST);
-        IVoxelRenderer::s_instance->RenderChunks(view, projection, light, frustum);
+        RecordGL([] { GLState::Get().SetEnabled(GL_DEPTH_TEST, true); });
+        GpuProfiler::Scope gpu(GpuProfiler::PassVoxels);
+        IVoxelRenderer::s_instance->RenderChunks(light, frustum);
     }
 
-    // ── 5b. All objects in layer order (3D + 2D mixed) ───────────────
+    // ── 5b. Build the render queue ───────────────────────────────────
+    // 2D elements before the first 3D model (in layer order) are a
+    // background; everything else 2D is an overlay on top of the 3D scene.
+    CpuProfiler::Scope queueZone("RenderSystem::DrawQueue");
+    s_queue.Clear();
+    float farPlane = cam ? cam->GetFar() : 100.0f;
+    bool seenModel = false;
+
     const auto &objects = scene->GetObjects();
     for (auto *obj : objects)
     {
         if (!obj->IsActive())
             continue;
 
-        // 3D model — depth test ON, frustum-culled
+        // 3D model — frustum-culled, state-sorted, front-to-back
         auto *model = obj->GetComponent<Model3DComponent>();
         if (model)
         {
-            Vector3 p = obj->GetPosition3D();
-            glm::vec3 pos(p.x, p.y, p.z);
-            float radius = 2.0f;
-            if (model->HasAabb())
-            {
-                glm::vec3 dims = model->GetModelDims();
-                radius = glm::length(dims) * 0.5f;
-                if (radius < 0.5f) radius = 0.5f;
-            }
-            if (!frustum.TestSphere(pos, radius))
+            seenModel = true;
+            const SharedMeshData *mesh = model->GetSharedMesh();
+            if (!mesh || mesh->meshes.empty())
+                continue;
+            glm::vec3 boundsMin, boundsMax;
+            model->GetWorldBounds(boundsMin, boundsMax);
+            if (!frustum.TestAABB(boundsMin, boundsMax))
                 continue;
 
-            glEnable(GL_DEPTH_TEST);
-            model->Render(view, projection, light);
+            glm::vec4 center = view * glm::vec4((boundsMin + boundsMax) * 0.5f, 1.0f);
+            GLuint texture = model->GetAlbedoOverride() ? model->GetAlbedoOverride() : mesh->meshes[0].diffuseTexture;
+            RenderQueue::Packet packet;
+            packet.key = RenderQueue::OpaqueKey(RenderQueue::ShaderModel, texture, s_queue.MeshId(mesh), -center.z / farPlane);
+            packet.component = model;
+            packet.kind = RenderQueue::KindModel;
+            packet.program = RenderQueue::ShaderModel;
+            packet.texture = texture;
+            packet.vao = mesh->meshes[0].VAO;
+            s_queue.Submit(packet);
             continue;
         }
 
-        // 2D sprite — depth test OFF
+        RenderQueue::Pass pass = seenModel ? RenderQueue::PassOverlay : RenderQueue::PassBackground;
+
+        // 2D sprite
         auto *image = obj->GetComponent<Image>();
-        if (image)
+        if (image && image->GetSprite())
         {
-            glDisable(GL_DEPTH_TEST);
-            image->Render();
+            Sprite *sprite = image->GetSprite();
+            RenderQueue::Packet packet;
+            packet.key = RenderQueue::OverlayKey(pass, obj->GetLayer(), s_queue.Size());
+            packet.component = image;
+            packet.kind = RenderQueue::KindImage;
+            packet.program = RenderQueue::ShaderSprite;
+            packet.texture = sprite->getTextureID();
+            packet.vao = SpriteBatch::Get().GetVAO();
+            s_queue.Submit(packet);
         }
 
-        // Text — depth test OFF
+        // Text (glyph quads from a shared atlas, drawn by SpriteBatch too)
         auto *text = obj->GetComponent<TextComponent>();
         if (text)
         {
-            glDisable(GL_DEPTH_TEST);
-            text->Render();
+            RenderQueue::Packet packet;
+            packet.key = RenderQueue::OverlayKey(pass, obj->GetLayer(), s_queue.Size());
+            packet.component = text;
+            packet.kind = RenderQueue::KindText;
+            packet.program = RenderQueue::ShaderSprite;
+            packet.texture = text->GetTextureID();
+            packet.vao = SpriteBatch::Get().GetVAO();
+            s_queue.Submit(packet);
+        }
+    }
+    s_queue.Sort();
+
+    // ── 5c. Submit in key order ──────────────────────────────────────
+    // Runs of 3D packets go through ModelBatch, which turns equal meshes
+    // into instanced draws; sprites and text go through SpriteBatch, which
+    // is flushed at the end of each 2D layer and before any 3D draw.
+    ModelBatch &models = ModelBatch::Get();
+    SpriteBatch &sprites = SpriteBatch::Get();
+    models.ResetStats();
+    sprites.ResetStats();
+    // The 2D timer spans each run of 2D packets, so it also covers the
+    // flushes SpriteBatch makes by itself while they queue quads.  Timer
+    // queries can't nest: it is closed before models are drawn.
+    std::optional<GpuProfiler::Scope> overlayGpu;
+    auto flushModels = [&]()
+    {
+        if (models.Empty())
+            return;
+        overlayGpu.reset();
+        RecordGL([] { GLState::Get().SetEnabled(GL_DEPTH_TEST, true); });
+        GpuProfiler::Scope gpu(GpuProfiler::PassModels);
+        models.FlushColor(light);
+    };
+    auto flushSprites = [&]()
+    {
+        if (sprites.Empty())
+            return;
+        sprites.Flush();
+    };
+    auto begin2D = [&]()
+    {
+        flushModels();
+        if (!overlayGpu)
+            overlayGpu.emplace(GpuProfiler::PassOverlay);
+        RecordGL([] { GLState::Get().SetEnabled(GL_DEPTH_TEST, false); });
+    };
+
+    uint64_t spriteLayer = ~0ull;
+    for (const auto &packet : s_queue.Packets())
+    {
+        if (packet.kind == RenderQueue::KindModel || RenderQueue::OverlayGroup(packet.key) != spriteLayer)
+            flushSprites();
+
+        switch (packet.kind)
+        {
+        case RenderQueue::KindModel:
+            models.Add(static_cast<Model3DComponent *>(packet.component));
+            break;
+        case RenderQueue::KindImage:
+            begin2D();
+            static_cast<Image *>(packet.component)->Render();
+            spriteLayer = RenderQueue::OverlayGroup(packet.key);
+            break;
+        case RenderQueue::KindText:
+            begin2D();
+            static_cast<TextComponent *>(packet.component)->Render();
+            spriteLayer = RenderQueue::OverlayGroup(packet.key);
+            break;
         }
     }
+    flushSprites();
+    overlayGpu.reset();
+    flushModels();
+    RecordGL([] { GLState::Get().SetEnabled(GL_DEPTH_TEST, true); });
 
-    glEnable(GL_DEPTH_TEST);
+    GpuProfiler::Get().EndFrame();
+    RecordGL([] { GLState::Get().EndFrame(); });
 }
@@ -0,0 +1,239 @@
+#include "RenderThread.h"
+#include "CpuProfiler.h"
+#include "GLState.h"
+#include <chrono>
+
+// Depth of GL access held by this thread (the render thread holds one while
+// it executes a frame), so nested GLContextLocks don't re-acquire.
+static thread_local int t_contextDepth = 0;
+
+// Names kept ready per kind; a chunk upload takes one VAO and two buffers
+// per texture group, so buffers run out first while the world streams in.
+static const size_t kNamePoolSize[RenderThread::NameKindCount] = {256, 128, 32};
+
+static void generateNames(RenderThread::NameKind kind, GLsizei count, GLuint* names)
+{
+    // GLState may still have a deleted object bound under a name that comes back
+    switch (kind) {
+    case RenderThread::NameBuffer:
+        glGenBuffers(count, names);
+        GLState::Get().Forget(GLState::KindBuffer, names, count);
+        break;
+    case RenderThread::NameVertexArray:
+        glGenVertexArrays(count, names);
+        GLState::Get().Forget(GLState::KindVertexArray, names, count);
+        break;
+    case RenderThread::NameTexture:
+        glGenTextures(count, names);
+        GLState::Get().Forget(GLState::KindTexture, names, count);
+        break;
+    default:
+        break;
+    }
+}
+
+void RenderCommandBuffer::Execute()
+{
+    CpuProfiler::Scope zone("RenderCommandBuffer::Execute");
+    for (auto& command : m_commands)
+        command();
+}
+
+RenderThread& RenderThread::Get() {
+    static RenderThread instance;
+    return instance;
+}
+
+void RenderThread::Start(SDL_Window* window, SDL_GLContext context, bool threaded, int maxQueuedFrames)
+{
+    if (m_started) Stop();
+    m_window = window;
+    m_context = context;
+    m_threaded = threaded && !m_null;
+    m_maxQueuedFrames = maxQueuedFrames < 1 ? 1 : maxQueuedFrames;
+    m_started = true;
+    if (!m_threaded) return;
+
+    // The render thread takes the context for each frame it executes
+    SDL_GL_MakeCurrent(m_window, nullptr);
+    m_running = true;
+    m_thread = std::thread(&RenderThread::run, this);
+}
+
+void RenderThread::Stop()
+{
+    if (!m_started) return;
+    if (m_threaded) {
+        Finish();
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            m_running = false;
+        }
+        m_queueChanged.notify_all();
+        m_thread.join();
+        SDL_GL_MakeCurrent(m_window, m_context);
+    }
+    // Anything recorded after the last submit still runs, in order
+    if (!m_null) m_recording.Execute();
+    m_recording.Clear();
+    releaseNames();
+    m_started = false;
+    m_threaded = false;
+}
+
+void RenderThread::Record(RenderCommandBuffer::Command command)
+{
+    if (!m_started && !m_null) {
+        command();
+        return;
+    }
+    m_recording.Record(std::move(command));
+}
+
+void RenderThread::SubmitFrame()
+{
+    if (!m_started) return;
+    m_stats.commands = (int)m_recording.Size();
+    m_stats.submitWaitMs = 0.0f;
+    if (!m_threaded) {
+        if (!m_null) {
+            t_contextDepth++;   // GL work inside the commands is nested, as on the render thread
+            m_recording.Execute();
+            refillNames();
+            t_contextDepth--;
+        }
+        m_recording.Clear();
+        return;
+    }
+
+    auto waitStart = std::chrono::high_resolution_clock::now();
+    {
+        CpuProfiler::Scope zone("RenderThread::WaitForQueue");
+        std::unique_lock<std::mutex> lock(m_queueMutex);
+        m_queueChanged.wait(lock, [this] { return (int)m_queue.size() < m_maxQueuedFrames; });
+        m_queue.push_back(std::move(m_recording));
+    }
+    m_queueChanged.notify_all();
+    m_recording = RenderCommandBuffer();
+    std::chrono::duration<float, std::milli> waited = std::chrono::high_resolution_clock::now() - waitStart;
+    m_stats.submitWaitMs = waited.count();
+}
+
+void RenderThread::Finish()
+{
+    if (!m_threaded || t_contextDepth > 0) return;
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+    m_queueChanged.wait(lock, [this] { return m_queue.empty() && !m_executing; });
+}
+
+void RenderThread::run()
+{
+    CpuProfiler::SetThreadName("Render");
+    for (;;) {
+        RenderCommandBuffer frame;
+        {
+            std::unique_lock<std::mutex> lock(m_queueMutex);
+            m_queueChanged.wait(lock, [this] { return !m_queue.empty() || !m_running; });
+            if (m_queue.empty()) return;
+            frame = std::move(m_queue.front());
+            m_queue.pop_front();
+            m_executing = true;
+        }
+        m_queueChanged.notify_all();   // a queue slot is free
+
+        {
+            std::lock_guard<std::mutex> context(m_contextMutex);
+            SDL_GL_MakeCurrent(m_window, m_context);
+            t_contextDepth++;
+            frame.Execute();
+            refillNames();
+            t_contextDepth--;
+            SDL_GL_MakeCurrent(m_window, nullptr);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            m_executing = false;
+        }
+        m_queueChanged.notify_all();
+    }
+}
+
+// ── GL names ─────────────────────────────────────────────────────────────────
+
+GLuint RenderThread::AllocateName(NameKind kind)
+{
+    if (m_null) return 0;
+    {
+        std::lock_guard<std::mutex> lock(m_namesMutex);
+        std::vector<GLuint>& pool = m_names[kind];
+        if (!pool.empty()) {
+            GLuint name = pool.back();
+            pool.pop_back();
+            return name;
+        }
+    }
+    // Pool empty (or not started yet): generate one here
+    GLContextLock gl;
+    GLuint name = 0;
+    generateNames(kind, 1, &name);
+    return name;
+}
+
+void RenderThread::refillNames()
+{
+    for (int k = 0; k < NameKindCount; ++k) {
+        size_t have;
+        {
+            std::lock_guard<std::mutex> lock(m_namesMutex);
+            have = m_names[k].size();
+        }
+        if (have >= kNamePoolSize[k] / 2) continue;   // top up in batches
+
+        std::vector<GLuint> fresh(kNamePoolSize[k] - have);
+        generateNames((NameKind)k, (GLsizei)fresh.size(), fresh.data());
+        std::lock_guard<std::mutex> lock(m_namesMutex);
+        m_names[k].insert(m_names[k].end(), fresh.begin(), fresh.end());
+    }
+}
+
+// Context current on the calling thread (Stop)
+void RenderThread::releaseNames()
+{
+    std::lock_guard<std::mutex> lock(m_namesMutex);
+    if (!m_null) {
+        std::vector<GLuint>& buffers = m_names[NameBuffer];
+        std::vector<GLuint>& arrays = m_names[NameVertexArray];
+        std::vector<GLuint>& textures = m_names[NameTexture];
+        if (!buffers.empty()) glDeleteBuffers((GLsizei)buffers.size(), buffers.data());
+        if (!arrays.empty()) glDeleteVertexArrays((GLsizei)arrays.size(), arrays.data());
+        if (!textures.empty()) glDeleteTextures((GLsizei)textures.size(), textures.data());
+    }
+    for (auto& pool : m_names) pool.clear();
+}
+
+// ── GLContextLock ────────────────────────────────────────────────────────────
+
+GLContextLock::GLContextLock()
+{
+    RenderThread& rt = RenderThread::Get();
+    m_outermost = t_contextDepth++ == 0;
+    if (!m_outermost || !rt.m_threaded) return;
+    rt.Finish();
+    rt.m_contextMutex.lock();
+    SDL_GL_MakeCurrent(rt.m_window, rt.m_context);
+    m_acquired = true;
+}
+
+GLContextLock::~GLContextLock()
+{
+    // Resource code binds objects directly, so GLState forgets its copy of
+    // the bindings.  Only the outermost lock on the main thread does it:
+    // still holding the context, so the render thread isn't using it.
+    if (m_outermost) GLState::Get().InvalidateBindings();
+    t_contextDepth--;
+    if (!m_acquired) return;
+    RenderThread& rt = RenderThread::Get();
+    SDL_GL_MakeCurrent(rt.m_window, nullptr);
+    rt.m_contextMutex.unlock();
+}
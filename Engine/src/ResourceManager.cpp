@@ -1,8 +1,18 @@
 #include "ResourceManager.h"
+#include "FrameUniforms.h"
+#include "RenderThread.h"
+#include "CpuProfiler.h"
+#include "GLState.h"
 #include <SDL.h>
 #include <SDL_image.h>
 #include <iostream>
 #include <algorithm>
+#include <iterator>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
@@ -20,6 +30,7 @@ GLuint ResourceManager::LoadTexture(const std::string& path) {
     auto it = m_textureCache.find(path);
     if (it != m_textureCache.end()) return it->second;
 
+    CpuProfiler::Scope zone("ResourceManager::LoadTexture");
     SDL_Surface* surface = IMG_Load(path.c_str());
     if (!surface) {
         std::cerr << "ResourceManager: cannot load '" << path
@@ -37,6 +48,7 @@ GLuint ResourceManager::LoadTextureFromMemory(const std::string& key,
     auto it = m_textureCache.find(key);
     if (it != m_textureCache.end()) return it->second;
 
+    CpuProfiler::Scope zone("ResourceManager::LoadTextureFromMemory");
     SDL_RWops* rw = SDL_RWFromConstMem(data.data(), (int)data.size());
     if (!rw) return 0;
     SDL_Surface* surface = IMG_Load_RW(rw, 1);
@@ -51,39 +63,226 @@ GLuint ResourceManager::LoadTextureFromMemory(const std::string& key,
     return id;
 }
 
-GLuint ResourceManager::uploadSurface(SDL_Surface* surface) {
+// FNV-1a over the encoded bytes.  Hashing is linear and far cheaper than
+// decoding, and 64 bits make an accidental collision between the handful of
+// images a game ships practically impossible.
+static uint64_t hashBytes(const void* data, size_t size, uint64_t h = 1469598103934665603ull) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        h ^= bytes[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+TextureHandle ResourceManager::AcquireTexture(const std::vector<unsigned char>& data) {
+    if (data.empty()) return TextureHandle();
+
+    CpuProfiler::Scope zone("ResourceManager::AcquireTexture");
+    uint64_t hash = hashBytes(data.data(), data.size());
+    auto it = m_sharedTextures.find(hash);
+    if (it != m_sharedTextures.end() && it->second.valid)
+        return TextureHandle(&it->second);
+
+    SDL_RWops* rw = SDL_RWFromConstMem(data.data(), (int)data.size());
+    if (!rw) return TextureHandle();
+    SDL_Surface* surface = IMG_Load_RW(rw, 1);
+    if (!surface) {
+        std::cerr << "ResourceManager: cannot decode sprite image: " << SDL_GetError() << std::endl;
+        return TextureHandle();
+    }
+
+    SharedTexture& tex = m_sharedTextures[hash];
+    tex.id = uploadSurface(surface, true);
+    tex.width = surface->w;
+    tex.height = surface->h;
+    tex.hash = hash;
+    // The null backend has no texture, but the image is real: sprites keep
+    // its size and identical bytes still share the entry.
+    tex.valid = tex.id != 0 || RenderThread::Get().IsNullBackend();
+    SDL_FreeSurface(surface);
+    return TextureHandle(&tex);
+}
+
+void ResourceManager::releaseTexture(SharedTexture* tex) {
+    if (--tex->refs > 0) return;
+    // Deleted at the end of the frame, after the draws recorded for it
+    if (tex->id) m_releasedTextures.push_back(tex->id);
+    m_sharedTextures.erase(tex->hash);
+}
+
+void TextureHandle::Reset() {
+    if (m_tex) ResourceManager::Get().releaseTexture(m_tex);
+    m_tex = nullptr;
+}
+
+// The texture name is valid at once; the upload is recorded ahead of any
+// draw that uses it, so loading mid-frame doesn't wait for queued frames.
+GLuint ResourceManager::uploadSurface(SDL_Surface* surface, bool sprite) {
     SDL_Surface* conv = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
-    if (!conv) return 0;
-
-    GLuint id;
-    glGenTextures(1, &id);
-    glBindTexture(GL_TEXTURE_2D, id);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA,
-                 conv->w, conv->h, 0, GL_RGBA, GL_UNSIGNED_BYTE, conv->pixels);
-    glGenerateMipmap(GL_TEXTURE_2D);
-    SDL_FreeSurface(conv);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    if (!conv || RenderThread::Get().IsNullBackend()) {
+        SDL_FreeSurface(conv);
+        return 0;
+    }
+
+    GLuint id = RenderThread::Get().AllocateName(RenderThread::NameTexture);
+    // The command owns the converted pixels (freed even if it never runs)
+    std::shared_ptr<SDL_Surface> pixels(conv, SDL_FreeSurface);
+    RecordGL([id, pixels, sprite] {
+        GLState::Get().BindTexture(0, GL_TEXTURE_2D, id);
+        // Sprites are drawn at roughly native size: no wrap, no mip sampling
+        GLint wrap = sprite ? GL_CLAMP_TO_EDGE : GL_REPEAT;
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, sprite ? GL_LINEAR : GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA,
+                     pixels->w, pixels->h, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels->pixels);
+        if (!sprite) glGenerateMipmap(GL_TEXTURE_2D);
+    });
     return id;
 }
 
 // ── Shaders ───────────────────────────────────────────────────────────────────
 
+void ResourceManager::RegisterShader(const std::string& name, const char* vertSrc, const char* fragSrc) {
+    m_shaderSources.try_emplace(name, ShaderSource{vertSrc, fragSrc});
+}
+
+GLuint ResourceManager::GetShader(const std::string& name) {
+    auto it = m_shaderCache.find(name);
+    if (it != m_shaderCache.end()) return it->second;
+
+    auto src = m_shaderSources.find(name);
+    if (src == m_shaderSources.end()) {
+        std::cerr << "ResourceManager: no shader registered as '" << name << "'" << std::endl;
+        return 0;
+    }
+    GLuint program = buildProgram(name, src->second);
+    m_shaderCache[name] = program;
+    return program;
+}
+
 GLuint ResourceManager::GetOrCreateShader(const std::string& name,
                                            const char* vertSrc,
                                            const char* fragSrc) {
     auto it = m_shaderCache.find(name);
     if (it != m_shaderCache.end()) return it->second;
 
-    GLuint program = compileProgram(vertSrc, fragSrc);
-    m_shaderCache[name] = program;
+    RegisterShader(name, vertSrc, fragSrc);
+    return GetShader(name);
+}
+
+void ResourceManager::RegisterShaderVariants(const std::string& name, const char* vertSrc, const char* fragSrc,
+                                             std::vector<std::string> featureDefines) {
+    m_shaderVariants.try_emplace(name, ShaderVariants{ShaderSource{vertSrc, fragSrc}, std::move(featureDefines), {}});
+}
+
+// Source with a #define for each set feature bit, placed after the #version
+// line (which must come first)
+static std::string withFeatureDefines(const std::string& source, const std::vector<std::string>& defines,
+                                      uint32_t features) {
+    std::string block;
+    for (size_t i = 0; i < defines.size(); ++i)
+        if (features & (1u << i)) block += "#define " + defines[i] + "\n";
+
+    size_t at = source.find("#version");
+    at = at == std::string::npos ? 0 : source.find('\n', at);
+    at = at == std::string::npos ? source.size() : at + 1;
+    return source.substr(0, at) + block + source.substr(at);
+}
+
+// Each variant is an ordinary registry entry, "name#mask", so it shares the
+// binary cache and ReleaseAll with every other program.
+std::string ResourceManager::registerVariant(const std::string& name, ShaderVariants& set, uint32_t features) {
+    std::string variantName = name + "#" + std::to_string(features);
+    if (m_shaderSources.find(variantName) == m_shaderSources.end())
+        m_shaderSources.emplace(variantName, ShaderSource{
+            withFeatureDefines(set.base.vertex, set.defines, features),
+            withFeatureDefines(set.base.fragment, set.defines, features)});
+    return variantName;
+}
+
+GLuint ResourceManager::GetShaderVariant(const std::string& name, uint32_t features) {
+    auto set = m_shaderVariants.find(name);
+    if (set == m_shaderVariants.end()) {
+        std::cerr << "ResourceManager: no shader variants registered as '" << name << "'" << std::endl;
+        return 0;
+    }
+    features &= (1u << set->second.defines.size()) - 1;   // bits without a define change nothing
+    auto it = set->second.programs.find(features);
+    if (it != set->second.programs.end()) return it->second;
+
+    GLuint program = GetShader(registerVariant(name, set->second, features));
+    set->second.programs.emplace(features, program);
     return program;
 }
 
+void ResourceManager::PreloadShaderVariant(const std::string& name, uint32_t features) {
+    auto set = m_shaderVariants.find(name);
+    if (set == m_shaderVariants.end()) return;
+    features &= (1u << set->second.defines.size()) - 1;
+    registerVariant(name, set->second, features);
+}
+
+void ResourceManager::PrecompileShaders() {
+    if (RenderThread::Get().IsNullBackend()) return;
+    CpuProfiler::Scope zone("ResourceManager::PrecompileShaders");
+    auto start = std::chrono::steady_clock::now();
+    ShaderStats before = m_shaderStats;
+
+    GLContextLock gl;   // one drain for the whole batch
+    for (const auto& [name, source] : m_shaderSources)
+        if (m_shaderCache.find(name) == m_shaderCache.end())
+            m_shaderCache[name] = buildProgram(name, source);
+
+    int compiled = m_shaderStats.compiled - before.compiled;
+    int fromBinary = m_shaderStats.fromBinary - before.fromBinary;
+    if (compiled + fromBinary > 0) {
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "ResourceManager: " << compiled + fromBinary << " shaders ready ("
+                  << fromBinary << " from the binary cache) in " << elapsed.count() << " ms" << std::endl;
+    }
+}
+
+GLuint ResourceManager::buildProgram(const std::string& name, const ShaderSource& source) {
+    if (RenderThread::Get().IsNullBackend()) return 0;
+    GLContextLock gl;
+
+    // A binary is only valid for the same sources on the same driver
+    std::string cachePath;
+    uint64_t key = 0;
+    bool useCache = !m_shaderCacheDir.empty() && programBinariesSupported();
+    if (useCache) {
+        key = hashBytes(m_driverKey.data(), m_driverKey.size());
+        key = hashBytes(source.vertex.data(), source.vertex.size() + 1, key);
+        key = hashBytes(source.fragment.data(), source.fragment.size() + 1, key);
+        cachePath = m_shaderCacheDir + "/" + name + ".bin";
+    }
+
+    GLuint prog = useCache ? loadProgramBinary(cachePath, key) : 0;
+    if (prog) {
+        m_shaderStats.fromBinary++;
+    } else {
+        prog = compileProgram(source.vertex.c_str(), source.fragment.c_str(), useCache);
+        m_shaderStats.compiled++;
+        GLint ok = GL_FALSE;
+        glGetProgramiv(prog, GL_LINK_STATUS, &ok);
+        if (useCache && ok) saveProgramBinary(prog, cachePath, key);
+    }
+
+    // The name may be a deleted program's; its cached uniform values are stale
+    GLState::Get().Forget(GLState::KindProgram, &prog, 1);
+
+    // Programs that declare the per-frame block read it from its fixed
+    // binding (a loaded binary starts from the default bindings too)
+    GLuint frameBlock = glGetUniformBlockIndex(prog, "FrameData");
+    if (frameBlock != GL_INVALID_INDEX)
+        glUniformBlockBinding(prog, frameBlock, FrameUniforms::kBindingPoint);
+    return prog;
+}
+
 static GLuint compileShader_impl(GLenum type, const char* src) {
     GLuint shader = glCreateShader(type);
     glShaderSource(shader, 1, &src, nullptr);
@@ -98,12 +297,15 @@ static GLuint compileShader_impl(GLenum type, const char* src) {
     return shader;
 }
 
-GLuint ResourceManager::compileProgram(const char* vertSrc, const char* fragSrc) {
+GLuint ResourceManager::compileProgram(const char* vertSrc, const char* fragSrc, bool retrievable) {
+    CpuProfiler::Scope zone("ResourceManager::compileProgram");
     GLuint vs   = compileShader_impl(GL_VERTEX_SHADER, vertSrc);
     GLuint fs   = compileShader_impl(GL_FRAGMENT_SHADER, fragSrc);
     GLuint prog = glCreateProgram();
     glAttachShader(prog, vs);
     glAttachShader(prog, fs);
+    if (retrievable)
+        glProgramParameteri(prog, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     glLinkProgram(prog);
     GLint ok;
     glGetProgramiv(prog, GL_LINK_STATUS, &ok);
@@ -117,6 +319,84 @@ GLuint ResourceManager::compileProgram(const char* vertSrc, const char* fragSrc)
     return prog;
 }
 
+// ── Program binary cache ──────────────────────────────────────────────────────
+//
+// One file per program: a header naming the binary format and the key it
+// was built for (sources + driver), then the driver's blob.  A stale or
+// rejected file is simply rebuilt and overwritten.
+
+namespace {
+struct ProgramBinaryHeader {
+    char magic[4];
+    uint32_t binaryFormat;
+    uint64_t key;
+    uint32_t length;
+};
+constexpr char kProgramBinaryMagic[4] = {'G', 'L', 'P', 'B'};
+}
+
+bool ResourceManager::programBinariesSupported() {
+    if (m_programBinaries < 0) {
+        // Core since 4.1; a 3.3 context needs ARB_get_program_binary
+        GLint formats = 0;
+        if (GLEW_ARB_get_program_binary)
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        m_programBinaries = formats > 0 ? 1 : 0;
+        for (GLenum e : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+            const GLubyte* str = glGetString(e);
+            m_driverKey += str ? reinterpret_cast<const char*>(str) : "";
+            m_driverKey += '\n';
+        }
+    }
+    return m_programBinaries == 1;
+}
+
+GLuint ResourceManager::loadProgramBinary(const std::string& path, uint64_t key) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return 0;
+    ProgramBinaryHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, kProgramBinaryMagic, 4) != 0 || header.key != key)
+        return 0;
+    std::vector<char> blob(header.length);
+    if (!file.read(blob.data(), blob.size())) return 0;
+
+    GLuint prog = glCreateProgram();
+    glProgramBinary(prog, header.binaryFormat, blob.data(), (GLsizei)blob.size());
+    GLint ok = GL_FALSE;
+    glGetProgramiv(prog, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        // The driver may refuse its own binaries after an update
+        glDeleteProgram(prog);
+        return 0;
+    }
+    return prog;
+}
+
+void ResourceManager::saveProgramBinary(GLuint program, const std::string& path, uint64_t key) {
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+    std::vector<char> blob(length);
+    ProgramBinaryHeader header;
+    std::memcpy(header.magic, kProgramBinaryMagic, 4);
+    header.key = key;
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &length, &format, blob.data());
+    header.binaryFormat = format;
+    header.length = (uint32_t)length;
+
+    std::error_code ec;
+    std::filesystem::create_directories(m_shaderCacheDir, ec);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "ResourceManager: cannot write shader cache '" << path << "'" << std::endl;
+        return;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(blob.data(), length);
+}
+
 // ── Meshes ────────────────────────────────────────────────────────────────────
 
 static void processMeshIntoShared(aiMesh* mesh, const aiScene* scene, const std::string& directory, SharedMeshData& out) {
@@ -165,30 +445,34 @@ static void processMeshIntoShared(aiMesh* mesh, const aiScene* scene, const std:
     }
 
     SharedMeshEntry entry;
-    glGenVertexArrays(1, &entry.VAO);
-    glGenBuffers(1, &entry.VBO);
-    glGenBuffers(1, &entry.EBO);
-
-    glBindVertexArray(entry.VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, entry.VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, entry.EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
-
-    int stride = 8 * sizeof(float);
-    // aPos (location 0)
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
-    glEnableVertexAttribArray(0);
-    // aTexCoord (location 1) — after pos(3) + normal(3)
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    // aNormal (location 2) — after pos(3)
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(2);
-
-    glBindVertexArray(0);
-
     entry.numIndices = (unsigned int)indices.size();
+    // The null backend keeps the entry (and its counts) without buffers
+    if (!RenderThread::Get().IsNullBackend()) {
+        RenderThread& rt = RenderThread::Get();
+        entry.VAO = rt.AllocateName(RenderThread::NameVertexArray);
+        entry.VBO = rt.AllocateName(RenderThread::NameBuffer);
+        entry.EBO = rt.AllocateName(RenderThread::NameBuffer);
+        // Recorded ahead of the draws that use the names
+        RecordGL([entry, vertices = std::move(vertices), indices = std::move(indices)] {
+            GLState& state = GLState::Get();
+            state.BindVertexArray(entry.VAO);
+            state.BindBuffer(GL_ARRAY_BUFFER, entry.VBO);
+            glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, entry.EBO);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+
+            int stride = 8 * sizeof(float);
+            // aPos (location 0)
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+            glEnableVertexAttribArray(0);
+            // aTexCoord (location 1) — after pos(3) + normal(3)
+            glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float)));
+            glEnableVertexAttribArray(1);
+            // aNormal (location 2) — after pos(3)
+            glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
+            glEnableVertexAttribArray(2);
+        });
+    }
 
     // Load diffuse texture from material
     if (mesh->mMaterialIndex < scene->mNumMaterials) {
@@ -215,6 +499,7 @@ const SharedMeshData* ResourceManager::GetOrLoadMesh(const std::string& path) {
     auto it = m_meshCache.find(path);
     if (it != m_meshCache.end()) return &it->second;
 
+    CpuProfiler::Scope zone("ResourceManager::GetOrLoadMesh");
     Assimp::Importer importer;
     const aiScene* scene = importer.ReadFile(path,
         aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs);
@@ -233,21 +518,50 @@ const SharedMeshData* ResourceManager::GetOrLoadMesh(const std::string& path) {
 
 // ── Lifecycle ─────────────────────────────────────────────────────────────────
 
+void ResourceManager::EndFrame() {
+    if (m_releasedTextures.empty()) return;
+    // Recorded, so frames already queued still sample them
+    RecordGL([ids = std::move(m_releasedTextures)] {
+        glDeleteTextures((GLsizei)ids.size(), ids.data());
+    });
+    m_releasedTextures.clear();
+}
+
 void ResourceManager::ReleaseAll() {
-    for (auto& [key, id] : m_textureCache)
-        glDeleteTextures(1, &id);
+    // Under the null backend nothing was created, so there is nothing to delete
+    const bool hasGL = !RenderThread::Get().IsNullBackend();
+    GLContextLock gl;
+    if (hasGL)
+        for (auto& [key, id] : m_textureCache)
+            glDeleteTextures(1, &id);
     m_textureCache.clear();
+    if (!m_releasedTextures.empty())
+        glDeleteTextures((GLsizei)m_releasedTextures.size(), m_releasedTextures.data());
+    m_releasedTextures.clear();
+
+    // Handles may outlive the GL context (scenes are destroyed after this),
+    // so referenced entries stay in the map with their id cleared.
+    for (auto it = m_sharedTextures.begin(); it != m_sharedTextures.end();) {
+        if (it->second.id) glDeleteTextures(1, &it->second.id);
+        it->second.id = 0;
+        it->second.valid = false;
+        it = it->second.refs > 0 ? std::next(it) : m_sharedTextures.erase(it);
+    }
 
-    for (auto& [name, prog] : m_shaderCache)
-        glDeleteProgram(prog);
+    if (hasGL)
+        for (auto& [name, prog] : m_shaderCache)
+            glDeleteProgram(prog);
     m_shaderCache.clear();
-
-    for (auto& [path, data] : m_meshCache) {
-        for (auto& mesh : data.meshes) {
-            glDeleteVertexArrays(1, &mesh.VAO);
-            glDeleteBuffers(1, &mesh.VBO);
-            glDeleteBuffers(1, &mesh.EBO);
+    for (auto& [name, set] : m_shaderVariants)
+        set.programs.clear();   // deleted above with the rest of the cache
+
+    if (hasGL)
+        for (auto& [path, data] : m_meshCache) {
+            for (auto& mesh : data.meshes) {
+                glDeleteVertexArrays(1, &mesh.VAO);
+                glDeleteBuffers(1, &mesh.VBO);
+                glDeleteBuffers(1, &mesh.EBO);
+            }
         }
-    }
     m_meshCache.clear();
 }
@@ -6,7 +6,7 @@
 #include <cmath>
 #include <iostream>
 
-void Rigidbody3D::Update(float dt)
+void Rigidbody3D::FixedUpdate(float dt)
 {
     if (!object) return;
 
@@ -20,7 +20,7 @@ void Rigidbody3D::Update(float dt)
     velocity += frameAccel * dt;
     object->SetPosition(object->GetPosition3D() + velocity * dt);
 
-    // Reset user-applied acceleration (gravity is re-applied each frame above)
+    // Reset user-applied acceleration (gravity is re-applied each step above)
     acceleration = Vector3(0, 0, 0);
 
     // Resolve collisions after movement
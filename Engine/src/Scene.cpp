@@ -4,6 +4,7 @@
 #include "sprite.h"
 #include "Renderer.h"
 #include "BoxCollider3D.h"
+#include "CpuProfiler.h"
 #include <algorithm>
 
 // ── Destructor ──────────────────────────────────────────────────────
@@ -57,6 +58,7 @@ void Scene::UpdateEvents(SDL_Event event) {
 }
 
 void Scene::UpdateScene(float deltaTime) {
+    CpuProfiler::Scope zone("Scene::UpdateScene");
     Update();
     // Pass 1: Logic update (skip static objects — they have no meaningful Update)
     for (size_t i = 0; i < objects.size(); ++i) {
@@ -74,6 +76,8 @@ void Scene::UpdateScene(float deltaTime) {
         }
     }
     flushPendingDeletes();
+    // Pass 4: World matrices of objects moved this frame (and their children)
+    updateTransforms();
     // Deferred layer sort — once per frame instead of per-object-creation
     if (layerDirty) {
         updateLayer();
@@ -81,6 +85,36 @@ void Scene::UpdateScene(float deltaTime) {
     }
 }
 
+void Scene::FixedUpdateScene(float fixedDeltaTime) {
+    CpuProfiler::Scope zone("Scene::FixedUpdateScene");
+    for (auto* obj : objects)
+        obj->beginFixedStep();
+    for (size_t i = 0; i < objects.size(); ++i) {
+        if (objects[i]->IsActive() && !objects[i]->IsStatic()) {
+            objects[i]->fixedUpdate(fixedDeltaTime);
+        }
+    }
+    flushPendingDeletes();
+    for (auto* obj : objects)
+        obj->endFixedStep();
+}
+
+void Scene::InterpolateTransforms(float alpha) {
+    for (auto* obj : objects) {
+        if (!obj->GetParent())
+            obj->updateRenderTransform(alpha);
+    }
+}
+
+// Walk each hierarchy from its root so parents are rebuilt before their
+// children.  Objects that did not move cost a flag test, no matrix math.
+void Scene::updateTransforms() {
+    for (auto* obj : objects) {
+        if (!obj->GetParent())
+            obj->updateWorldTransform();
+    }
+}
+
 // ── Object management ───────────────────────────────────────────────
 
 Object* Scene::CreateObject() {
@@ -114,6 +148,10 @@ Sprite* Scene::createSprite(const std::vector<unsigned char>& imageData) {
     return new Sprite(imageData);
 }
 
+Sprite* Scene::createSprite(const TextureHandle& texture) {
+    return new Sprite(texture);
+}
+
 void Scene::updateLayer() {
     std::sort(objects.begin(), objects.end(), [](const auto& a, const auto& b) {
         return a->GetLayer() < b->GetLayer();
@@ -123,8 +161,9 @@ void Scene::updateLayer() {
 // ── Window / scene switching ────────────────────────────────────────
 
 Vector2 Scene::GetWindowSize() {
-    int w, h;
-    SDL_GetWindowSize(m_window, &w, &h);
+    // No window when headless: report the size the renderer was given
+    int w = Renderer::Get().GetWindowWidth(), h = Renderer::Get().GetWindowHeight();
+    if (m_window) SDL_GetWindowSize(m_window, &w, &h);
     return Vector2((float)w, (float)h);
 }
 
@@ -150,6 +189,7 @@ void Scene::SetWindowSize(const int& w, const int& h) {
 
 void Scene::dispatchCollisions()
 {
+    CpuProfiler::Scope zone("Scene::dispatchCollisions");
     // Gather all active objects that carry a BoxCollider3D
     std::vector<std::pair<Object*, BoxCollider3D*>> colliders;
     colliders.reserve(64);
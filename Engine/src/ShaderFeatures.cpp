@@ -0,0 +1,27 @@
+#include "ShaderFeatures.h"
+#include "LightComponent.h"
+
+const std::vector<std::string>& ShaderFeatures::Defines()
+{
+    static const std::vector<std::string> defines = {
+        "INSTANCED",
+        "SHADOWS",
+        "SHADOW_TAPS 4",
+        "SHADOW_TAPS 9",
+        "SHADOW_TAPS 16",
+        "HIGHLIGHT",
+    };
+    return defines;
+}
+
+uint32_t ShaderFeatures::ForLight(const LightComponent* light)
+{
+    if (!light || !light->IsShadowEnabled() || !light->GetDepthTexture())
+        return 0;
+    switch (light->GetShadowQuality()) {
+    case LightComponent::ShadowLow:    return Shadows | ShadowPcf4;
+    case LightComponent::ShadowMedium: return Shadows | ShadowPcf9;
+    case LightComponent::ShadowHigh:   return Shadows | ShadowPcf16;
+    default:                           return Shadows;
+    }
+}
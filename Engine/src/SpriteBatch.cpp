@@ -0,0 +1,232 @@
+#include "SpriteBatch.h"
+#include "Renderer.h"
+#include "ResourceManager.h"
+#include "RenderThread.h"
+#include "GLState.h"
+#include <cmath>
+#include <unordered_map>
+
+static const char* vertexShaderSource = R"(
+#version 330 core
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec2 aTexCoord;
+layout (location = 2) in vec4 aColor;
+
+uniform mat4 projection;
+
+out vec2 TexCoord;
+out vec4 Color;
+
+void main()
+{
+    gl_Position = projection * vec4(aPos, 0.0, 1.0);
+    TexCoord = aTexCoord;
+    Color = aColor;
+}
+)";
+
+static const char* fragmentShaderSource = R"(
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+in vec4 Color;
+uniform sampler2D spriteTexture;
+
+void main()
+{
+    FragColor = texture(spriteTexture, TexCoord) * Color;
+}
+)";
+
+// Distance-field variant.  fwidth() gives the distance change per screen
+// pixel, so the edge is always smoothed over about one pixel whatever the
+// scale or rotation of the quad.
+static const char* distanceFieldFragmentShaderSource = R"(
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+in vec4 Color;
+uniform sampler2D spriteTexture;
+uniform vec4 outlineColor;
+uniform float outlineWidth;
+
+void main()
+{
+    float dist = texture(spriteTexture, TexCoord).a;
+    float w = max(fwidth(dist), 1e-4);
+    float fill = smoothstep(0.5 - w, 0.5 + w, dist);
+    float outer = smoothstep(0.5 - outlineWidth - w, 0.5 - outlineWidth + w, dist);
+    vec4 col = mix(outlineColor, Color, outlineWidth > 0.0 ? fill : 1.0);
+    FragColor = vec4(col.rgb, col.a * outer);
+}
+)";
+
+SpriteBatch& SpriteBatch::Get() {
+    static SpriteBatch instance;
+    return instance;
+}
+
+void SpriteBatch::RegisterShaders()
+{
+    ResourceManager::Get().RegisterShader("sprite_batch", vertexShaderSource, fragmentShaderSource);
+    ResourceManager::Get().RegisterShader("sprite_batch_sdf", vertexShaderSource, distanceFieldFragmentShaderSource);
+}
+
+void SpriteBatch::init()
+{
+    m_vertices.reserve(kMaxQuads * 4);
+    if (RenderThread::Get().IsNullBackend()) return;
+
+    // Index pattern is fixed, so it is uploaded once for the largest batch
+    std::vector<GLushort> indices(kMaxQuads * 6);
+    for (int q = 0; q < kMaxQuads; ++q) {
+        GLushort base = (GLushort)(q * 4);
+        GLushort* i = &indices[q * 6];
+        i[0] = base; i[1] = base + 1; i[2] = base + 2;
+        i[3] = base + 2; i[4] = base + 3; i[5] = base;
+    }
+
+    RenderThread& rt = RenderThread::Get();
+    m_vao = rt.AllocateName(RenderThread::NameVertexArray);
+    m_vbo = rt.AllocateName(RenderThread::NameBuffer);
+    m_ebo = rt.AllocateName(RenderThread::NameBuffer);
+    RecordGL([vao = m_vao, vbo = m_vbo, ebo = m_ebo, indices = std::move(indices)] {
+        GLState& state = GLState::Get();
+        state.BindVertexArray(vao);
+        state.BindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferData(GL_ARRAY_BUFFER, kMaxQuads * 4 * sizeof(Vertex), nullptr, GL_STREAM_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLushort), indices.data(), GL_STATIC_DRAW);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(2 * sizeof(float)));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(4 * sizeof(float)));
+        glEnableVertexAttribArray(2);
+    });
+}
+
+void SpriteBatch::Draw(GLuint texture, const glm::vec2& position, const glm::vec2& size, float angle,
+                       const glm::vec4& color, const glm::vec4& uvRect)
+{
+    static const Style plain;
+    Draw(texture, position, size, angle, color, uvRect, plain);
+}
+
+void SpriteBatch::Draw(GLuint texture, const glm::vec2& position, const glm::vec2& size, float angle,
+                       const glm::vec4& color, const glm::vec4& uvRect, const Style& style)
+{
+    if (texture != m_texture || style != m_style || (int)m_vertices.size() >= kMaxQuads * 4) {
+        Flush();
+        m_texture = texture;
+        m_style = style;
+    }
+
+    // Same transform Sprite used to build on the GPU: scale the unit quad,
+    // rotate it about its centre, then move it to `position`.
+    float hw = size.x * 0.5f, hh = size.y * 0.5f;
+    float rad = angle * 3.14159265f / 180.0f;
+    float c = std::cos(rad), s = std::sin(rad);
+    float cx = position.x + hw, cy = position.y + hh;
+
+    // Unit-quad corners in the order the index pattern expects
+    static const float corners[4][2] = { {0.0f, 1.0f}, {1.0f, 1.0f}, {1.0f, 0.0f}, {0.0f, 0.0f} };
+    for (const auto& k : corners) {
+        float lx = k[0] * size.x - hw;
+        float ly = k[1] * size.y - hh;
+        Vertex v;
+        v.x = cx + lx * c - ly * s;
+        v.y = cy + lx * s + ly * c;
+        v.u = uvRect.x + k[0] * (uvRect.z - uvRect.x);
+        v.v = uvRect.y + k[1] * (uvRect.w - uvRect.y);
+        v.r = color.x; v.g = color.y; v.b = color.z; v.a = color.w;
+        m_vertices.push_back(v);
+    }
+    m_stats.quads++;
+}
+
+void SpriteBatch::Flush()
+{
+    if (m_vertices.empty()) return;
+    if (!m_vao) init();
+
+    GLuint prog = ResourceManager::Get().GetShader(m_style.distanceField ? "sprite_batch_sdf" : "sprite_batch");
+    glm::mat4 projection = Renderer::Get().GetOrthoProjection();
+    m_stats.drawCalls++;
+
+    // The recorded draw takes the vertices and hands the array back when
+    // done; the next batch starts with an empty array from the pool
+    RecordGL([this, prog, projection, texture = m_texture, style = m_style, vao = m_vao, vbo = m_vbo,
+              vertices = std::move(m_vertices)]() mutable {
+        GLState& state = GLState::Get();
+        state.UseProgram(prog);
+
+        struct Uniforms {
+            GLint projection, spriteTexture, outlineColor, outlineWidth;
+        };
+        static std::unordered_map<GLuint, Uniforms> uniformCache;
+        auto it = uniformCache.find(prog);
+        if (it == uniformCache.end()) {
+            Uniforms u;
+            u.projection = glGetUniformLocation(prog, "projection");
+            u.spriteTexture = glGetUniformLocation(prog, "spriteTexture");
+            u.outlineColor = glGetUniformLocation(prog, "outlineColor");
+            u.outlineWidth = glGetUniformLocation(prog, "outlineWidth");
+            it = uniformCache.emplace(prog, u).first;
+        }
+        const Uniforms& u = it->second;
+
+        state.SetUniform(u.projection, projection);
+        state.BindTexture(0, GL_TEXTURE_2D, texture);
+        state.SetUniform(u.spriteTexture, 0);
+        if (style.distanceField) {
+            state.SetUniform(u.outlineColor, style.outlineColor);
+            state.SetUniform(u.outlineWidth, style.outlineWidth);
+        }
+
+        // Orphan the previous contents, then upload only what is used
+        state.BindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferData(GL_ARRAY_BUFFER, kMaxQuads * 4 * sizeof(Vertex), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(Vertex), vertices.data());
+
+        state.BindVertexArray(vao);
+        glDrawElements(GL_TRIANGLES, (GLsizei)(vertices.size() / 4 * 6), GL_UNSIGNED_SHORT, 0);
+        returnVertexArray(std::move(vertices));
+    });
+
+    m_vertices = takeVertexArray();
+}
+
+std::vector<SpriteBatch::Vertex> SpriteBatch::takeVertexArray()
+{
+    std::lock_guard<std::mutex> lock(m_poolMutex);
+    if (m_vertexPool.empty()) return {};
+    std::vector<Vertex> vertices = std::move(m_vertexPool.back());
+    m_vertexPool.pop_back();
+    return vertices;
+}
+
+void SpriteBatch::returnVertexArray(std::vector<Vertex>&& vertices)
+{
+    vertices.clear();
+    std::lock_guard<std::mutex> lock(m_poolMutex);
+    if (m_vertexPool.size() < kMaxPooledArrays)
+        m_vertexPool.push_back(std::move(vertices));
+}
+
+void SpriteBatch::Release()
+{
+    GLContextLock gl;
+    if (m_vao) {
+        glDeleteVertexArrays(1, &m_vao);
+        glDeleteBuffers(1, &m_vbo);
+        glDeleteBuffers(1, &m_ebo);
+    }
+    m_vao = m_vbo = m_ebo = 0;
+    m_vertices.clear();
+    m_vertexPool.clear();
+    m_texture = 0;
+    m_style = Style();
+}
@@ -1,8 +1,13 @@
 #include "VoxelRenderer.h"
 #include "ResourceManager.h"
 #include "LightComponent.h"
+#include "FrameUniforms.h"
+#include "RenderThread.h"
+#include "ShaderFeatures.h"
+#include "GLState.h"
 #include <GL/glew.h>
-#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <string>
 
 VoxelRenderer& VoxelRenderer::Get() {
     static VoxelRenderer instance;
@@ -20,57 +25,107 @@ VoxelRenderer::~VoxelRenderer() {
     }
 }
 
+// Deletion is recorded, so it runs after the queued frames that still draw
+// these buffers and never stalls the main thread.
+void VoxelRenderer::freeMeshGroups(std::vector<MeshGroup>& groups) {
+    if (groups.empty()) return;
+    RecordGL([groups = std::move(groups)]() mutable {
+        for (auto& mg : groups) {
+            if (mg.VAO) glDeleteVertexArrays(1, &mg.VAO);
+            if (mg.VBO) glDeleteBuffers(1, &mg.VBO);
+            if (mg.EBO) glDeleteBuffers(1, &mg.EBO);
+        }
+    });
+    groups.clear();
+}
+
 void VoxelRenderer::freeChunkMeshes(ChunkRenderData& chunk) {
-    for (auto& mg : chunk.meshGroups) {
-        if (mg.VAO) glDeleteVertexArrays(1, &mg.VAO);
-        if (mg.VBO) glDeleteBuffers(1, &mg.VBO);
-        if (mg.EBO) glDeleteBuffers(1, &mg.EBO);
+    for (auto& part : chunk.parts) {
+        freeMeshGroups(part);
     }
-    chunk.meshGroups.clear();
 }
 
-void VoxelRenderer::UpdateChunk(int cx, int cz, const glm::vec3& aabbMin, const glm::vec3& aabbMax, const std::vector<VoxelMeshData>& meshes) {
-    ChunkKey key{cx, cz};
-    auto& chunk = m_chunks[key];
-    freeChunkMeshes(chunk);
+void VoxelRenderer::uploadMeshGroups(std::vector<MeshGroup>& groups, std::vector<VoxelMeshData>& meshes) {
+    freeMeshGroups(groups);
 
-    chunk.aabbMin = aabbMin;
-    chunk.aabbMax = aabbMax;
-
-    for (const auto& meshData : meshes) {
+    // Buffer names come from the render thread's pool and the upload is
+    // recorded ahead of the draws that use them, so streaming chunks in
+    // never waits for queued frames.  The null backend keeps buffer-less
+    // groups, so culling and draw counts still behave as with a GPU.
+    RenderThread& rt = RenderThread::Get();
+    const bool hasGL = !rt.IsNullBackend();
+    for (auto& meshData : meshes) {
         if (meshData.indices.empty()) continue;
 
         MeshGroup mg;
         mg.textureId = meshData.textureId;
         mg.numIndices = (unsigned int)meshData.indices.size();
+        if (!hasGL) {
+            groups.push_back(mg);
+            continue;
+        }
 
-        glGenVertexArrays(1, &mg.VAO);
-        glGenBuffers(1, &mg.VBO);
-        glGenBuffers(1, &mg.EBO);
-
-        glBindVertexArray(mg.VAO);
-        glBindBuffer(GL_ARRAY_BUFFER, mg.VBO);
-        glBufferData(GL_ARRAY_BUFFER, meshData.vertices.size() * sizeof(float), meshData.vertices.data(), GL_STATIC_DRAW);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mg.EBO);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, meshData.indices.size() * sizeof(unsigned int), meshData.indices.data(), GL_STATIC_DRAW);
-
-        int stride = 8 * sizeof(float);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float)));
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
-        glEnableVertexAttribArray(2);
-
-        glBindVertexArray(0);
-        chunk.meshGroups.push_back(mg);
+        mg.VAO = rt.AllocateName(RenderThread::NameVertexArray);
+        mg.VBO = rt.AllocateName(RenderThread::NameBuffer);
+        mg.EBO = rt.AllocateName(RenderThread::NameBuffer);
+        // The command gets its own copy; the scratch vectors keep their capacity
+        RecordGL([mg, vertices = meshData.vertices, indices = meshData.indices] {
+            GLState& state = GLState::Get();
+            state.BindVertexArray(mg.VAO);
+            state.BindBuffer(GL_ARRAY_BUFFER, mg.VBO);
+            glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mg.EBO);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+
+            int stride = 8 * sizeof(float);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float)));
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
+            glEnableVertexAttribArray(2);
+        });
+        groups.push_back(mg);
+
+        meshData.vertices.clear();
+        meshData.indices.clear();
     }
 }
 
+void VoxelRenderer::UpdateChunk(int cx, int cz, const glm::vec3& aabbMin, const glm::vec3& aabbMax, std::vector<VoxelMeshData>& meshes) {
+    ChunkKey key{cx, cz};
+    auto [it, inserted] = m_chunks.try_emplace(key);
+    auto& chunk = it->second;
+
+    bool boundsChanged = chunk.aabbMin != aabbMin || chunk.aabbMax != aabbMax;
+    if (!inserted && boundsChanged) markChanged(key, chunk.aabbMin, chunk.aabbMax); // old extent
+    markChanged(key, aabbMin, aabbMax);
+    chunk.aabbMin = aabbMin;
+    chunk.aabbMax = aabbMax;
+    if (inserted) {
+        linkChunk(key, &chunk);
+    } else if (boundsChanged) {
+        ChunkKey clusterKey{cx >> kClusterShift, cz >> kClusterShift};
+        refitCluster(clusterKey);
+        refitRegion(ChunkKey{clusterKey.cx >> kRegionShift, clusterKey.cz >> kRegionShift});
+    }
+    uploadMeshGroups(chunk.parts[PartBody], meshes);
+}
+
+void VoxelRenderer::UpdateChunkPart(int cx, int cz, int part, std::vector<VoxelMeshData>& meshes) {
+    if (part < 0 || part >= PartCount) return;
+    auto it = m_chunks.find(ChunkKey{cx, cz});
+    if (it == m_chunks.end()) return;
+    markChanged(it->first, it->second.aabbMin, it->second.aabbMax);
+    uploadMeshGroups(it->second.parts[part], meshes);
+}
+
 void VoxelRenderer::RemoveChunk(int cx, int cz) {
     ChunkKey key{cx, cz};
     auto it = m_chunks.find(key);
     if (it != m_chunks.end()) {
+        markChanged(key, it->second.aabbMin, it->second.aabbMax);
+        unlinkChunk(key, &it->second);
         freeChunkMeshes(it->second);
         m_chunks.erase(it);
     }
@@ -81,6 +136,148 @@ void VoxelRenderer::Clear() {
         freeChunkMeshes(kv.second);
     }
     m_chunks.clear();
+    m_clusters.clear();
+    m_regions.clear();
+    m_changed.clear();
+    m_changedAll = true;
+}
+
+void VoxelRenderer::markChanged(const ChunkKey& key, const glm::vec3& mn, const glm::vec3& mx) {
+    if (m_changedAll) return;
+    if (m_changed.size() >= kMaxChangedChunks) {
+        m_changed.clear();
+        m_changedAll = true;
+        return;
+    }
+    auto [it, inserted] = m_changed.try_emplace(key, Bounds{mn, mx});
+    if (!inserted) {
+        it->second.min = glm::min(it->second.min, mn);
+        it->second.max = glm::max(it->second.max, mx);
+    }
+}
+
+bool VoxelRenderer::TakeChangedBounds(std::vector<Bounds>& out) {
+    out.clear();
+    // After Clear() the geometry that was removed is gone from the region
+    // tree, so no box over what is loaded now would cover its shadows.
+    bool all = m_changedAll;
+    if (!all)
+        for (const auto& kv : m_changed) out.push_back(kv.second);
+    m_changed.clear();
+    m_changedAll = false;
+    return all;
+}
+
+// ── Culling hierarchy ────────────────────────────────────────────────────
+
+void VoxelRenderer::linkChunk(const ChunkKey& key, ChunkRenderData* chunk) {
+    ChunkKey clusterKey{key.cx >> kClusterShift, key.cz >> kClusterShift};
+    ChunkKey regionKey{clusterKey.cx >> kRegionShift, clusterKey.cz >> kRegionShift};
+
+    auto [cit, newCluster] = m_clusters.try_emplace(clusterKey);
+    cit->second.chunks.push_back(chunk);
+    if (newCluster) m_regions[regionKey].clusters.push_back(&cit->second);
+
+    refitCluster(clusterKey);
+    refitRegion(regionKey);
+}
+
+void VoxelRenderer::unlinkChunk(const ChunkKey& key, ChunkRenderData* chunk) {
+    ChunkKey clusterKey{key.cx >> kClusterShift, key.cz >> kClusterShift};
+    ChunkKey regionKey{clusterKey.cx >> kRegionShift, clusterKey.cz >> kRegionShift};
+
+    auto cit = m_clusters.find(clusterKey);
+    if (cit == m_clusters.end()) return;
+    auto& chunks = cit->second.chunks;
+    auto pos = std::find(chunks.begin(), chunks.end(), chunk);
+    if (pos != chunks.end()) {
+        *pos = chunks.back();
+        chunks.pop_back();
+    }
+
+    if (!chunks.empty()) {
+        refitCluster(clusterKey);
+        refitRegion(regionKey);
+        return;
+    }
+
+    // Last chunk gone: drop the cluster, and the region if it empties too.
+    auto rit = m_regions.find(regionKey);
+    if (rit != m_regions.end()) {
+        auto& clusters = rit->second.clusters;
+        auto cpos = std::find(clusters.begin(), clusters.end(), &cit->second);
+        if (cpos != clusters.end()) {
+            *cpos = clusters.back();
+            clusters.pop_back();
+        }
+        if (clusters.empty()) m_regions.erase(rit);
+        else refitRegion(regionKey);
+    }
+    m_clusters.erase(cit);
+}
+
+void VoxelRenderer::refitCluster(const ChunkKey& clusterKey) {
+    auto it = m_clusters.find(clusterKey);
+    if (it == m_clusters.end() || it->second.chunks.empty()) return;
+    Cluster& cluster = it->second;
+    cluster.aabbMin = cluster.chunks[0]->aabbMin;
+    cluster.aabbMax = cluster.chunks[0]->aabbMax;
+    for (const ChunkRenderData* c : cluster.chunks) {
+        cluster.aabbMin = glm::min(cluster.aabbMin, c->aabbMin);
+        cluster.aabbMax = glm::max(cluster.aabbMax, c->aabbMax);
+    }
+}
+
+void VoxelRenderer::refitRegion(const ChunkKey& regionKey) {
+    auto it = m_regions.find(regionKey);
+    if (it == m_regions.end() || it->second.clusters.empty()) return;
+    Region& region = it->second;
+    region.aabbMin = region.clusters[0]->aabbMin;
+    region.aabbMax = region.clusters[0]->aabbMax;
+    for (const Cluster* c : region.clusters) {
+        region.aabbMin = glm::min(region.aabbMin, c->aabbMin);
+        region.aabbMax = glm::max(region.aabbMax, c->aabbMax);
+    }
+}
+
+/// Walk regions -> clusters -> chunks, calling fn(chunk) for every
+/// non-empty chunk that may be visible.  Planes a parent is fully inside of
+/// are not re-tested on its children; a fully inside node needs no tests.
+template <typename Fn>
+void VoxelRenderer::forEachVisibleChunk(const Frustum& frustum, CullSlot slot, Fn&& fn) {
+    CullStats& stats = m_cullStats[slot];
+    stats = CullStats();
+
+    for (auto& [rk, region] : m_regions) {
+        ++stats.regionsTested;
+        unsigned regionMask = Frustum::kAllPlanes;
+        if (frustum.ClassifyAABB(region.aabbMin, region.aabbMax, regionMask,
+                                 region.lastRejectPlane[slot]) == Frustum::Outside)
+            continue;
+
+        for (Cluster* cluster : region.clusters) {
+            unsigned clusterMask = regionMask;
+            if (clusterMask) {
+                ++stats.clustersTested;
+                if (frustum.ClassifyAABB(cluster->aabbMin, cluster->aabbMax, clusterMask,
+                                         cluster->lastRejectPlane[slot]) == Frustum::Outside)
+                    continue;
+            }
+
+            for (ChunkRenderData* chunk : cluster->chunks) {
+                if (chunk->Empty()) continue;
+                if (clusterMask) {
+                    unsigned chunkMask = clusterMask;
+                    ++stats.chunksTested;
+                    if (frustum.ClassifyAABB(chunk->aabbMin, chunk->aabbMax, chunkMask,
+                                             chunk->lastRejectPlane[slot]) == Frustum::Outside)
+                        continue;
+                }
+                ++stats.chunksVisible;
+                fn(*chunk);
+            }
+        }
+    }
 }
 
 void VoxelRenderer::SetHighlight(const glm::vec3& pos, bool active, float blockHalfSize) {
@@ -91,189 +288,206 @@ void VoxelRenderer::SetHighlight(const glm::vec3& pos, bool active, float blockH
 
 unsigned int VoxelRenderer::getDummyShadow() {
     static GLuint dummy = 0;
-    if (!dummy) {
-        glGenTextures(1, &dummy);
-        glBindTexture(GL_TEXTURE_2D, dummy);
-        unsigned char w = 255;
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, 1, 1, 0, GL_RED, GL_UNSIGNED_BYTE, &w);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glBindTexture(GL_TEXTURE_2D, 0);
+    if (!dummy && !RenderThread::Get().IsNullBackend()) {
+        dummy = RenderThread::Get().AllocateName(RenderThread::NameTexture);
+        // Recorded ahead of the draw that samples it
+        RecordGL([dummy = dummy] {
+            GLState::Get().BindTexture(1, GL_TEXTURE_2D_ARRAY, dummy);
+            // Complete depth texture with comparison enabled, to match sampler2DArrayShadow
+            float far = 1.0f;
+            glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, 1, 1, 1, 0, GL_DEPTH_COMPONENT, GL_FLOAT, &far);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+        });
     }
     return dummy;
 }
 
-unsigned int VoxelRenderer::getOrCreateChunkShader() {
-    static const char* vs = R"(
-#version 330 core
+unsigned int VoxelRenderer::getChunkShader(uint32_t features) {
+    return ResourceManager::Get().GetShaderVariant("chunk_mesh", features);
+}
+
+void VoxelRenderer::RegisterShaders() {
+    // Camera, light and cascade data come from the FrameData block
+    const std::string vs = std::string("#version 330 core\n") + FrameUniforms::kBlockSource + R"(
 layout(location=0) in vec3 aPos;
 layout(location=1) in vec2 aTexCoord;
 layout(location=2) in vec3 aNormal;
 out vec2 TexCoord;
 out vec3 Normal;
 out vec3 FragPos;
-out vec4 LightSpacePos;
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-uniform mat4 lightVP;
+out float ViewDepth;
 void main(){
-    vec4 worldPos = model * vec4(aPos, 1.0);
-    gl_Position = projection * view * worldPos;
+    vec4 worldPos = vec4(aPos, 1.0);   // chunk meshes are built in world space
+    vec4 viewPos = view * worldPos;
+    gl_Position = projection * viewPos;
     FragPos  = worldPos.xyz;
     TexCoord = aTexCoord;
     Normal   = aNormal;
-    LightSpacePos = lightVP * worldPos;
+    ViewDepth = -viewPos.z;
 })";
-    static const char* fs = R"(
-#version 330 core
+    const std::string fs = std::string("#version 330 core\n") + FrameUniforms::kBlockSource + R"(
 out vec4 FragColor;
 in vec2 TexCoord;
 in vec3 Normal;
 in vec3 FragPos;
-in vec4 LightSpacePos;
+in float ViewDepth;
 uniform sampler2D ourTexture;
-uniform sampler2D shadowMap;
-uniform vec3 lightDir;
-uniform vec3 lightColor;
-uniform vec3 ambientColor;
-uniform int useShadows;
+#ifdef HIGHLIGHT
 uniform vec3 highlightPos;
-uniform int highlightActive;
 uniform float blockHalfSize;
-
-float ShadowCalc(vec4 lsp, vec3 n, vec3 ld){
+#endif
+
+#ifdef SHADOWS
+#ifndef SHADOW_TAPS
+#define SHADOW_TAPS 1
+#endif
+uniform sampler2DArrayShadow shadowMap;
+// Ordered so that the first 4 and first 9 taps are each evenly spread
+const vec2 kPoisson[16] = vec2[](
+    vec2(-0.26496911,-0.41893023), vec2( 0.53742981,-0.47373420),
+    vec2(-0.38277543, 0.27676845), vec2( 0.34495938, 0.29387760),
+    vec2(-0.94201624,-0.39906216), vec2( 0.94558609,-0.76890725),
+    vec2(-0.91588581, 0.45771432), vec2( 0.97484398, 0.75648379),
+    vec2( 0.14383161,-0.14100790), vec2(-0.09418410,-0.92938870),
+    vec2(-0.81544232,-0.87912464), vec2( 0.44323325,-0.97511554),
+    vec2( 0.79197514, 0.19090188), vec2(-0.24188840, 0.99706507),
+    vec2(-0.81409955, 0.91437590), vec2( 0.19984126, 0.78641367));
+
+float ShadowCalc(vec3 wp, float depth, vec3 n, vec3 ld){
+    int cascadeCount = shadowParams.y;
+    float last = cascadeSplits[cascadeCount-1];
+    if(depth > last) return 0.0;
+    int c = 0;
+    while(c < cascadeCount-1 && depth > cascadeSplits[c]) ++c;
+    vec4 lsp = lightVPs[c] * vec4(wp, 1.0);
     vec3 p = lsp.xyz / lsp.w * 0.5 + 0.5;
     if(p.z>1.0||p.x<0.0||p.x>1.0||p.y<0.0||p.y>1.0) return 0.0;
     float cosT = max(dot(normalize(n), -normalize(ld)), 0.0);
-    float bias = mix(0.002, 0.0004, cosT);
-    float shadow = 0.0;
-    vec2 ts = 1.0 / textureSize(shadowMap, 0);
-    for(int x=-2;x<=2;++x) for(int y=-2;y<=2;++y){
-        float d = texture(shadowMap, p.xy + vec2(x,y)*ts).r;
-        shadow += (p.z - bias) > d ? 1.0 : 0.0;
-    }
-    shadow /= 25.0;
-    float fr = 0.05;
-    float f = smoothstep(0.0,fr,p.x)*smoothstep(0.0,fr,1.0-p.x)
-             *smoothstep(0.0,fr,p.y)*smoothstep(0.0,fr,1.0-p.y);
-    return shadow * f;
+    float bias = mix(0.002, 0.0004, cosT) * (1.0 + float(c));
+    // Hardware comparison: each tap is a bilinear 2x2 PCF lookup
+    float ref = p.z - bias;
+#if SHADOW_TAPS <= 1
+    float lit = texture(shadowMap, vec4(p.xy, float(c), ref));
+#else
+    float lit = 0.0;
+    vec2 ts = 1.5 / vec2(textureSize(shadowMap, 0).xy);
+    for(int i=0;i<SHADOW_TAPS;++i)
+        lit += texture(shadowMap, vec4(p.xy + kPoisson[i]*ts, float(c), ref));
+    lit /= float(SHADOW_TAPS);
+#endif
+    float shadow = 1.0 - lit;
+    // Fade out over the last 10% of the shadow distance
+    return shadow * (1.0 - smoothstep(last*0.9, last, depth));
 }
+#endif
 void main(){
     vec3 tex = texture(ourTexture, TexCoord).rgb;
     vec3 n = normalize(Normal);
-    float diff = max(dot(n, -lightDir), 0.0);
-    float shadow = useShadows==1 ? ShadowCalc(LightSpacePos, n, lightDir) : 0.0;
-    vec3 result = tex * (ambientColor + (1.0-shadow)*diff*lightColor);
-    if(highlightActive==1){
-        vec3 d = abs(FragPos - highlightPos);
-        if(d.x < blockHalfSize*1.01 && d.y < blockHalfSize*1.01 && d.z < blockHalfSize*1.01)
-            result = mix(result, vec3(1.0,1.0,0.4), 0.18);
-    }
+    float diff = max(dot(n, -lightDir.xyz), 0.0);
+#ifdef SHADOWS
+    float shadow = ShadowCalc(FragPos, ViewDepth, n, lightDir.xyz);
+#else
+    float shadow = 0.0;
+#endif
+    vec3 result = tex * (ambientColor.rgb + (1.0-shadow)*diff*lightColor.rgb);
+#ifdef HIGHLIGHT
+    vec3 d = abs(FragPos - highlightPos);
+    if(d.x < blockHalfSize*1.01 && d.y < blockHalfSize*1.01 && d.z < blockHalfSize*1.01)
+        result = mix(result, vec3(1.0,1.0,0.4), 0.18);
+#endif
     FragColor = vec4(result, 1.0);
 })";
-    return ResourceManager::Get().GetOrCreateShader("chunk_mesh", vs, fs);
+    ResourceManager& rm = ResourceManager::Get();
+    rm.RegisterShaderVariants("chunk_mesh", vs.c_str(), fs.c_str(), ShaderFeatures::Defines());
+    // Default light, with and without a highlighted block
+    const uint32_t shadowed = ShaderFeatures::Shadows | ShaderFeatures::ShadowPcf9;
+    rm.PreloadShaderVariant("chunk_mesh", shadowed);
+    rm.PreloadShaderVariant("chunk_mesh", shadowed | ShaderFeatures::Highlight);
 }
 
-void VoxelRenderer::RenderChunks(const glm::mat4& view, const glm::mat4& projection, LightComponent* light, const Frustum& frustum) {
-    GLuint prog = getOrCreateChunkShader();
-    glUseProgram(prog);
-
-    struct Uniforms {
-        GLint model, view, projection, lightDir, lightColor, ambientColor, lightVP, useShadows, shadowMap, highlightPos, highlightActive, blockHalfSize, ourTexture;
-    };
-    static std::unordered_map<GLuint, Uniforms> uniformCache;
-    auto it = uniformCache.find(prog);
-    if (it == uniformCache.end()) {
-        Uniforms u;
-        u.model = glGetUniformLocation(prog, "model");
-        u.view = glGetUniformLocation(prog, "view");
-        u.projection = glGetUniformLocation(prog, "projection");
-        u.lightDir = glGetUniformLocation(prog, "lightDir");
-        u.lightColor = glGetUniformLocation(prog, "lightColor");
-        u.ambientColor = glGetUniformLocation(prog, "ambientColor");
-        u.lightVP = glGetUniformLocation(prog, "lightVP");
-        u.useShadows = glGetUniformLocation(prog, "useShadows");
-        u.shadowMap = glGetUniformLocation(prog, "shadowMap");
-        u.highlightPos = glGetUniformLocation(prog, "highlightPos");
-        u.highlightActive = glGetUniformLocation(prog, "highlightActive");
-        u.blockHalfSize = glGetUniformLocation(prog, "blockHalfSize");
-        u.ourTexture = glGetUniformLocation(prog, "ourTexture");
-        uniformCache[prog] = u;
-        it = uniformCache.find(prog);
-    }
-    const Uniforms& u = it->second;
-
-    glm::mat4 model(1.0f);
-    glUniformMatrix4fv(u.model, 1, GL_FALSE, glm::value_ptr(model));
-    glUniformMatrix4fv(u.view, 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(u.projection, 1, GL_FALSE, glm::value_ptr(projection));
-
-    glm::vec3 lightDir(0, 0, -1), lightColor(1), ambientColor(0.2f);
-    glm::mat4 lightVP(1.0f);
-    int useShadows = 0;
-    if (light) {
-        lightDir = light->GetDirection();
-        lightColor = light->GetColor();
-        ambientColor = light->GetAmbient();
-        lightVP = light->GetLightVP();
-        useShadows = (light->IsShadowEnabled() && light->GetDepthTexture()) ? 1 : 0;
-    }
-    glUniform3fv(u.lightDir, 1, glm::value_ptr(lightDir));
-    glUniform3fv(u.lightColor, 1, glm::value_ptr(lightColor));
-    glUniform3fv(u.ambientColor, 1, glm::value_ptr(ambientColor));
-    glUniformMatrix4fv(u.lightVP, 1, GL_FALSE, glm::value_ptr(lightVP));
-    glUniform1i(u.useShadows, useShadows);
-
-    GLuint shadowTex = (light && light->GetDepthTexture()) ? light->GetDepthTexture() : getDummyShadow();
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, shadowTex);
-    glUniform1i(u.shadowMap, 1);
-
-    glUniform3fv(u.highlightPos, 1, glm::value_ptr(m_highlightPos));
-    glUniform1i(u.highlightActive, m_highlightActive ? 1 : 0);
-    glUniform1f(u.blockHalfSize, m_blockHalfSize);
-
-    for (const auto& [cc, chunk] : m_chunks) {
-        if (chunk.meshGroups.empty()) continue;
-
-        if (!frustum.TestAABB(chunk.aabbMin, chunk.aabbMax)) continue;
-
-        for (const auto& mg : chunk.meshGroups) {
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, mg.textureId);
-            glUniform1i(u.ourTexture, 0);
-            glBindVertexArray(mg.VAO);
-            glDrawElements(GL_TRIANGLES, mg.numIndices, GL_UNSIGNED_INT, 0);
-            glBindVertexArray(0);
+void VoxelRenderer::RenderChunks(LightComponent* light, const Frustum& frustum) {
+    uint32_t features = ShaderFeatures::ForLight(light);
+    if (m_highlightActive) features |= ShaderFeatures::Highlight;
+    GLuint prog = getChunkShader(features);
+    GLuint shadowTex = (features & ShaderFeatures::Shadows) ? light->GetDepthTexture() : getDummyShadow();
+
+    // Cull here; the recorded command gets only what it draws
+    std::vector<MeshGroup> visible;
+    forEachVisibleChunk(frustum, CullCamera, [&](const ChunkRenderData& chunk) {
+        for (const auto& part : chunk.parts)
+            visible.insert(visible.end(), part.begin(), part.end());
+    });
+    // Culling yields chunk -> part -> texture order; group equal textures
+    // so the draw loop binds each one once
+    std::sort(visible.begin(), visible.end(), [](const MeshGroup& a, const MeshGroup& b) {
+        return a.textureId != b.textureId ? a.textureId < b.textureId : a.VAO < b.VAO;
+    });
+
+    RecordGL([prog, shadowTex, highlightPos = m_highlightPos,
+              blockHalfSize = m_blockHalfSize, visible = std::move(visible)] {
+        GLState& state = GLState::Get();
+        state.UseProgram(prog);
+
+        struct Uniforms {
+            GLint shadowMap, highlightPos, blockHalfSize, ourTexture;
+        };
+        static std::unordered_map<GLuint, Uniforms> uniformCache;
+        auto it = uniformCache.find(prog);
+        if (it == uniformCache.end()) {
+            Uniforms u;
+            u.shadowMap = glGetUniformLocation(prog, "shadowMap");
+            u.highlightPos = glGetUniformLocation(prog, "highlightPos");
+            u.blockHalfSize = glGetUniformLocation(prog, "blockHalfSize");
+            u.ourTexture = glGetUniformLocation(prog, "ourTexture");
+            uniformCache[prog] = u;
+            it = uniformCache.find(prog);
         }
-    }
-    glUseProgram(0);
-}
+        const Uniforms& u = it->second;
 
-void VoxelRenderer::RenderChunksDepth(GLuint depthProgram, const glm::mat4& lightVP, const Frustum& lightFrustum) {
-    static std::unordered_map<GLuint, GLint> depthModelLocCache;
-    GLint modelLoc;
-    auto it = depthModelLocCache.find(depthProgram);
-    if (it == depthModelLocCache.end()) {
-        modelLoc = glGetUniformLocation(depthProgram, "model");
-        depthModelLocCache[depthProgram] = modelLoc;
-    } else {
-        modelLoc = it->second;
-    }
+        state.BindTexture(1, GL_TEXTURE_2D_ARRAY, shadowTex);
+        state.SetUniform(u.shadowMap, 1);
+        state.SetUniform(u.ourTexture, 0);
 
-    glm::mat4 model(1.0f);
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
+        state.SetUniform(u.highlightPos, highlightPos);
+        state.SetUniform(u.blockHalfSize, blockHalfSize);
+
+        // Sorted by texture: only the VAO changes inside a texture run
+        for (const auto& mg : visible) {
+            state.BindTexture(0, GL_TEXTURE_2D, mg.textureId);
+            state.BindVertexArray(mg.VAO);
+            glDrawElements(GL_TRIANGLES, mg.numIndices, GL_UNSIGNED_INT, 0);
+        }
+    });
+}
 
-    for (const auto& [cc, chunk] : m_chunks) {
-        if (chunk.meshGroups.empty()) continue;
+void VoxelRenderer::RenderChunksDepth(GLuint depthProgram, const glm::mat4& lightVP, const Frustum& lightFrustum, int cascade) {
+    if (cascade < 0 || cascade >= kMaxShadowCascades) cascade = 0;
+    std::vector<MeshGroup> visible;
+    forEachVisibleChunk(lightFrustum, CullSlot(CullShadow0 + cascade), [&](const ChunkRenderData& chunk) {
+        for (const auto& part : chunk.parts)
+            visible.insert(visible.end(), part.begin(), part.end());
+    });
+
+    RecordGL([depthProgram, visible = std::move(visible)] {
+        static std::unordered_map<GLuint, GLint> depthModelLocCache;
+        GLint modelLoc;
+        auto it = depthModelLocCache.find(depthProgram);
+        if (it == depthModelLocCache.end()) {
+            modelLoc = glGetUniformLocation(depthProgram, "model");
+            depthModelLocCache[depthProgram] = modelLoc;
+        } else {
+            modelLoc = it->second;
+        }
 
-        if (!lightFrustum.TestAABB(chunk.aabbMin, chunk.aabbMax)) continue;
+        GLState& state = GLState::Get();
+        state.SetUniform(modelLoc, glm::mat4(1.0f));
 
-        for (const auto& mg : chunk.meshGroups) {
-            glBindVertexArray(mg.VAO);
+        for (const auto& mg : visible) {
+            state.BindVertexArray(mg.VAO);
             glDrawElements(GL_TRIANGLES, mg.numIndices, GL_UNSIGNED_INT, 0);
-            glBindVertexArray(0);
         }
-    }
+    });
 }
@@ -9,48 +9,106 @@
 #include "Renderer.h"
 #include "InputManager.h"
 #include "ResourceManager.h"
+#include "ModelBatch.h"
+#include "SpriteBatch.h"
+#include "Model3DComponent.h"
+#include "LightComponent.h"
+#include "VoxelRenderer.h"
+#include "FontAtlas.h"
+#include "FrameUniforms.h"
+#include "GpuProfiler.h"
+#include "CpuProfiler.h"
 #include "ArchiveUnpacker.h"
 #include "RenderSystem.h"
+#include "RenderThread.h"
+#include "GLState.h"
 #include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <thread>
 #include <GL/glew.h>
 
 struct Engine::Impl
 {
     Impl() {}
+    // Restart SDL video on another driver (it was initialised with the
+    // default one, which needs a display).
+    static bool restartVideo(const char *driver)
+    {
+        SDL_QuitSubSystem(SDL_INIT_VIDEO);
+        SDL_SetHint(SDL_HINT_VIDEODRIVER, driver);
+        if (SDL_InitSubSystem(SDL_INIT_VIDEO) != 0)
+        {
+            std::cerr << "Engine: SDL video driver '" << driver << "' unavailable: " << SDL_GetError() << std::endl;
+            return false;
+        }
+        return true;
+    }
+
     void preInit()
     {
+        if (backend == RenderBackend::Offscreen && !restartVideo("offscreen"))
+            backend = RenderBackend::Null;
+        if (backend == RenderBackend::Null)
+        {
+            // The dummy driver still delivers events and keyboard state
+            restartVideo("dummy");
+            RenderThread::Get().SetNullBackend(true);
+            std::cout << "Engine: headless, null render backend" << std::endl;
+            return;
+        }
+
         SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
         SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
         SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
         SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
         SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 24);
 
-        m_window = SDL_CreateWindow("Game", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 1280, 720, SDL_WINDOW_OPENGL | SDL_WINDOW_SHOWN);
-        SDL_GLContext glContext = SDL_GL_CreateContext(m_window);
+        Uint32 flags = SDL_WINDOW_OPENGL | (backend == RenderBackend::Offscreen ? SDL_WINDOW_HIDDEN : SDL_WINDOW_SHOWN);
+        m_window = SDL_CreateWindow("Game", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 1280, 720, flags);
+        m_glContext = m_window ? SDL_GL_CreateContext(m_window) : nullptr;
+        if (!m_glContext && backend == RenderBackend::Offscreen)
+        {
+            std::cerr << "Engine: no offscreen GL context (" << SDL_GetError() << "), using the null backend" << std::endl;
+            SDL_DestroyWindow(m_window);
+            m_window = nullptr;
+            backend = RenderBackend::Null;
+            RenderThread::Get().SetNullBackend(true);
+            return;
+        }
         glewExperimental = GL_TRUE;
         if (glewInit() != GLEW_OK)
         {
             std::cerr << "GLEW initialization error!" << std::endl;
         }
-        glEnable(GL_DEPTH_TEST);
-        glDepthFunc(GL_LEQUAL);
-        glEnable(GL_CULL_FACE);
-        glCullFace(GL_BACK);
+        if (backend == RenderBackend::Offscreen)
+            std::cout << "Engine: headless, offscreen GL on " << glGetString(GL_RENDERER) << std::endl;
+        GLState& state = GLState::Get();
+        state.Invalidate();   // a new context: nothing cached applies to it
+        state.SetEnabled(GL_DEPTH_TEST, true);
+        state.DepthFunc(GL_LEQUAL);
+        state.SetEnabled(GL_CULL_FACE, true);
+        state.CullFace(GL_BACK);
         glFrontFace(GL_CCW);
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        state.SetEnabled(GL_BLEND, true);
+        state.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     }
 
     void Tick(float deltaTime)
     {
+        CpuProfiler::Scope zone("Engine::Tick");
+
         // Clean up scenes that were replaced/popped last frame.
         sceneManager.FlushPending();
 
-        int ww, wh;
-        SDL_GetWindowSize(m_window, &ww, &wh);
+        // Headless without a window keeps the last size it was given
+        int ww = Renderer::Get().GetWindowWidth(), wh = Renderer::Get().GetWindowHeight();
+        if (m_window != nullptr)
+            SDL_GetWindowSize(m_window, &ww, &wh);
         Renderer::Get().SetWindowSize(ww, wh);
-        glViewport(0, 0, ww, wh);
+        RecordGL([ww, wh] { GLState::Get().Viewport(0, 0, ww, wh); });
 
         InputManager::Get().BeginFrame();
 
@@ -58,9 +116,12 @@ struct Engine::Impl
         while (SDL_PollEvent(&event))
         {
             InputManager::Get().ProcessEvent(event);
+            CpuProfiler::Get().ProcessEvent(event);
 
             if (event.type == SDL_QUIT)
             {
+                running = false;
+                RenderThread::Get().Stop();
                 SDL_DestroyWindow(m_window);
                 m_window = nullptr;
             }
@@ -70,23 +131,99 @@ struct Engine::Impl
                 active->UpdateEvents(event);
         }
 
-        glClearColor(0, 100 / 255.0f, 1.0f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        RecordGL([] {
+            glClearColor(0, 100 / 255.0f, 1.0f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        });
 
+        // Fixed-rate simulation: run as many ticks as the elapsed time
+        // covers.  A long stall (loading, a breakpoint) is clamped, and
+        // after maxFixedSteps the backlog is dropped rather than letting
+        // slow ticks fall further and further behind.
         Scene *active = sceneManager.GetActiveScene();
         if (active != nullptr)
+        {
+            accumulator += std::min((double)deltaTime, kMaxFrameTime);
+            int steps = 0;
+            while (accumulator >= fixedDeltaTime && steps < maxFixedSteps)
+            {
+                active->FixedUpdateScene((float)fixedDeltaTime);
+                accumulator -= fixedDeltaTime;
+                ++steps;
+            }
+            if (accumulator >= fixedDeltaTime)
+                accumulator = std::fmod(accumulator, fixedDeltaTime);
             active->UpdateScene(deltaTime);
+        }
+        else
+        {
+            accumulator = 0.0;
+        }
 
         // Render all objects via the centralised RenderSystem
         active = sceneManager.GetActiveScene();
         if (active != nullptr)
+        {
+            active->InterpolateTransforms((float)(accumulator / fixedDeltaTime));
             RenderSystem::Render(active);
+        }
+
+        // Textures released this frame go after its last draw
+        ResourceManager::Get().EndFrame();
 
-        SDL_GL_SwapWindow(m_window);
+        // The frame is recorded; the render thread replays and presents it
+        // while the next one is simulated.
+        if (m_window != nullptr)
+        {
+            SDL_Window *window = m_window;
+            RecordGL([window] { SDL_GL_SwapWindow(window); });
+        }
+        RenderThread::Get().SubmitFrame();
     }
 
+    // Frame cap without drift: deadlines advance by the exact period, so
+    // 60 FPS is 60 frames a second rather than 1000 / 16 ms.  Sleep while
+    // the OS timer granularity allows, then spin the last stretch.  With
+    // vsync the swap paces frames instead.
+    void waitForNextFrame(std::chrono::steady_clock::time_point &deadline)
+    {
+        using clock = std::chrono::steady_clock;
+        if (vsync || FPS <= 0)
+            return;
+        auto period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / FPS));
+        deadline += period;
+        auto now = clock::now();
+        if (now >= deadline)
+        {
+            // Missed by more than a frame: start over instead of rushing
+            // out a burst of frames to catch up.
+            if (now - deadline > period)
+                deadline = now;
+            return;
+        }
+        CpuProfiler::Scope zone("Engine::WaitForNextFrame");
+        auto sleepFor = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now - kSpinWindow);
+        if (sleepFor.count() > 0)
+            SDL_Delay((Uint32)sleepFor.count());
+        while (clock::now() < deadline)
+            std::this_thread::yield();
+    }
+
+    static constexpr double kMaxFrameTime = 0.25;                  // seconds of simulation per frame, at most
+    static constexpr std::chrono::milliseconds kSpinWindow{2};     // below this, spin instead of sleeping
+
     int FPS = 60;
+    bool vsync = false;
+    double fixedDeltaTime = 1.0 / 60.0;
+    int maxFixedSteps = 8;
+    double accumulator = 0.0;
     SDL_Window *m_window = nullptr;
+    SDL_GLContext m_glContext = nullptr;
+    RenderBackend backend = RenderBackend::Window;
+    bool running = false;
+    int frameLimit = 0;
+    bool threadedRendering = true;
+    int maxQueuedFrames = 1;
     std::string nameWindow;
 
     SceneManager sceneManager;
@@ -117,27 +254,57 @@ void Engine::Run()
     impl->preInit();
     impl->sceneManager.Bind(this, impl->m_window);
 
+    CpuProfiler::SetThreadName("Main");
+
+    // Engine programs are registered up front; the game may add its own
+    // in Init() and they are all built below, before the first frame.
+    SpriteBatch::RegisterShaders();
+    ModelBatch::RegisterShaders();
+    Model3DComponent::RegisterShaders();
+    LightComponent::RegisterShaders();
+    VoxelRenderer::RegisterShaders();
+
     Init();
 
-    auto lastFrameTime = std::chrono::high_resolution_clock::now();
-    int frameDelay = 1000 / impl->FPS;
+    ResourceManager::Get().PrecompileShaders();
 
-    while (impl->m_window != nullptr)
+    // Swap interval belongs to the context; set it before the render
+    // thread takes it over
+    if (impl->m_glContext != nullptr)
+        SDL_GL_SetSwapInterval(impl->vsync ? 1 : 0);
+    RenderThread::Get().Start(impl->m_window, impl->m_glContext, impl->threadedRendering, impl->maxQueuedFrames);
+
+    using clock = std::chrono::steady_clock;
+    auto runStart = clock::now();
+    auto lastFrameTime = runStart;
+    auto nextFrame = lastFrameTime;
+    int frames = 0;
+    long long commands = 0;
+
+    impl->running = true;
+    while (impl->running)
     {
-        auto frameStart = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<float, std::milli> frameDuration = frameStart - lastFrameTime;
+        auto frameStart = clock::now();
+        std::chrono::duration<float> frameDuration = frameStart - lastFrameTime;
         lastFrameTime = frameStart;
 
-        impl->Tick(frameDuration.count() / 1000.0f);
-
-        auto frameEnd = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<float, std::milli> elapsedTime = frameEnd - frameStart;
-        int elapsedMS = static_cast<int>(elapsedTime.count());
+        impl->Tick(frameDuration.count());
+        CpuProfiler::Get().EndFrame();
+        commands += RenderThread::Get().GetStats().commands;
+        if (++frames == impl->frameLimit)
+            impl->running = false;
+        else
+            impl->waitForNextFrame(nextFrame);
+    }
 
-        if (frameDelay > elapsedMS)
-        {
-            SDL_Delay(frameDelay - elapsedMS);
-        }
+    if (impl->frameLimit > 0 && frames > 0)
+    {
+        std::chrono::duration<double, std::milli> elapsed = clock::now() - runStart;
+        std::cout << "Engine: " << frames << " frames in " << elapsed.count() / 1000.0 << " s, "
+                  << elapsed.count() / frames << " ms/frame, "
+                  << commands / frames << " GL commands/frame" << std::endl;
+        if (!RenderThread::Get().IsNullBackend())
+            std::cout << "Engine: last frame " << GLState::Get().FormatSummary() << std::endl;
     }
 }
 
@@ -168,6 +335,41 @@ ArchiveUnpacker *Engine::GetResourcesArchive()
 
 void Engine::SetFPS(const int &fps) { impl->FPS = fps; };
 
+void Engine::SetVSync(bool enabled) { impl->vsync = enabled; }
+
+void Engine::SetTickRate(int ticksPerSecond, int maxStepsPerFrame)
+{
+    if (ticksPerSecond > 0)
+        impl->fixedDeltaTime = 1.0 / ticksPerSecond;
+    impl->maxFixedSteps = std::max(1, maxStepsPerFrame);
+}
+
+void Engine::SetRenderThreading(bool threaded, int maxQueuedFrames)
+{
+    impl->threadedRendering = threaded;
+    impl->maxQueuedFrames = maxQueuedFrames;
+}
+
+void Engine::SetRenderBackend(RenderBackend backend) { impl->backend = backend; }
+
+void Engine::SetFrameLimit(int frames) { impl->frameLimit = std::max(0, frames); }
+
+void Engine::ParseCommandLine(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--headless")
+            SetRenderBackend(RenderBackend::Offscreen);
+        else if (arg == "--headless=null")
+            SetRenderBackend(RenderBackend::Null);
+        else if (arg.rfind("--frames=", 0) == 0)
+            SetFrameLimit(std::atoi(arg.c_str() + 9));
+        else if (arg == "--uncapped")
+            SetFPS(0);
+    }
+}
+
 void Engine::SetWindowSize(const int &w, const int &h)
 {
     SDL_SetWindowSize(impl->m_window, w, h);
@@ -181,13 +383,22 @@ void Engine::SetWindowTitle(const std::string &newTitle)
 
 void Engine::Quit()
 {
+    impl->running = false;
+    RenderThread::Get().Stop();
     SDL_DestroyWindow(impl->m_window);
+    impl->m_window = nullptr;
     IMG_Quit();
     SDL_Quit();
 }
 
 Engine::~Engine()
 {
+    RenderThread::Get().Stop();
+    ModelBatch::Get().Release();
+    SpriteBatch::Get().Release();
+    FontAtlas::ReleaseAll();
+    FrameUniforms::Get().Release();
+    GpuProfiler::Get().Release();
     ResourceManager::Get().ReleaseAll();
     SDL_DestroyWindow(impl->m_window);
     IMG_Quit();
@@ -4,6 +4,8 @@
 #include "Utils.h"
 #include <typeinfo>
 #include "Scene.h"
+#include <algorithm>
+#include <glm/gtc/matrix_transform.hpp>
 
 Object::Object(Scene *scene) : currentScene(scene)
 {
@@ -40,20 +42,24 @@ void Object::SetPosition(const Vector2 &vec2)
 {
 	position.x = vec2.x;
 	position.y = vec2.y;
+	markTransformDirty();
 }
 
 void Object::SetPosition(const Vector3 &vec3)
 {
 	position = vec3;
+	markTransformDirty();
 }
 
 void Object::SetRotation(float angle)
 {
 	this->angle.z = angle;
+	markTransformDirty();
 }
 void Object::SetRotation(const Vector3& angle)
 {
 	this->angle = angle;
+	markTransformDirty();
 }
 void Object::SetPositionOnPlatform(const Vector2 &vec2)
 {
@@ -63,11 +69,13 @@ void Object::SetPositionOnPlatform(const Vector2 &vec2)
 void Object::MoveY(const float &pos_y)
 {
 	position.y += pos_y;
+	markTransformDirty();
 }
 
 void Object::MoveX(const float &pos_x)
 {
 	position.x += pos_x;
+	markTransformDirty();
 }
 
 Vector2 Object::GetSize()
@@ -79,16 +87,19 @@ void Object::InitSize(Image *img)
 {
 	if (img != nullptr)
 		size = img->GetSize().toVector3();
+	markTransformDirty();
 }
 
 void Object::SetSize(const Vector2 &vec2)
 {
 	size = vec2.toVector3();
+	markTransformDirty();
 }
 
 void Object::SetSize(const Vector3 &vec3)
 {
 	size = vec3;
+	markTransformDirty();
 }
 
 void Object::InitSize()
@@ -96,6 +107,136 @@ void Object::InitSize()
 	Image *img = GetComponent<Image>();
 	if (img != nullptr)
 		size = img->GetSize().toVector3();
+	markTransformDirty();
+}
+
+// ── Hierarchy ───────────────────────────────────────────────────────
+
+void Object::SetParent(Object *newParent)
+{
+	if (newParent == parent)
+		return;
+	for (Object *p = newParent; p; p = p->parent)
+		if (p == this)
+			return;
+	if (parent)
+		parent->children.erase(std::remove(parent->children.begin(), parent->children.end(), this), parent->children.end());
+	parent = newParent;
+	if (parent)
+		parent->children.push_back(this);
+	markTransformDirty();
+}
+
+static glm::mat4 localMatrix(const Vector3 &position, const Vector3 &angle)
+{
+	glm::mat4 local = glm::translate(glm::mat4(1.0f), glm::vec3(position.x, position.y, position.z));
+	local = glm::rotate(local, glm::radians(angle.x), glm::vec3(1, 0, 0));
+	local = glm::rotate(local, glm::radians(angle.y), glm::vec3(0, 1, 0));
+	local = glm::rotate(local, glm::radians(angle.z), glm::vec3(0, 0, 1));
+	return local;
+}
+
+void Object::rebuildWorldMatrix() const
+{
+	glm::mat4 local = localMatrix(position, angle);
+	m_worldMatrix = parent ? parent->m_worldMatrix * local : local;
+	m_parentVersion = parent ? parent->m_worldVersion : 0;
+	m_worldVersion++;
+	m_transformDirty = false;
+}
+
+const glm::mat4 &Object::GetWorldMatrix() const
+{
+	// Lazy path for reads between the batched updates: bring the parent
+	// chain up to date first, then this object if anything above changed.
+	if (parent)
+	{
+		parent->GetWorldMatrix();
+		if (parent->m_worldVersion != m_parentVersion)
+			m_transformDirty = true;
+	}
+	if (m_transformDirty)
+		rebuildWorldMatrix();
+	return m_worldMatrix;
+}
+
+Vector3 Object::GetWorldPosition3D() const
+{
+	const glm::mat4 &world = GetWorldMatrix();
+	return Vector3(world[3].x, world[3].y, world[3].z);
+}
+
+Vector3 Object::GetRenderWorldPosition3D() const
+{
+	const glm::mat4 &world = GetRenderMatrix();
+	return Vector3(world[3].x, world[3].y, world[3].z);
+}
+
+Vector3 Object::GetRenderWorldAngle() const
+{
+	Vector3 total = m_renderAngle;
+	for (const Object *p = parent; p; p = p->parent)
+		total = total + p->m_renderAngle;
+	return total;
+}
+
+void Object::updateWorldTransform()
+{
+	if (m_transformDirty || (parent && parent->m_worldVersion != m_parentVersion))
+		rebuildWorldMatrix();
+	for (Object *child : children)
+		child->updateWorldTransform();
+}
+
+void Object::beginFixedStep()
+{
+	m_tickStartPosition = position;
+	m_tickStartAngle = angle;
+	m_inFixedStep = true;
+}
+
+void Object::endFixedStep()
+{
+	// Created during the step: it appeared where it is, nothing to blend
+	if (!m_inFixedStep)
+	{
+		m_tickStartPosition = position;
+		m_tickStartAngle = angle;
+	}
+	m_tickEndPosition = position;
+	m_tickEndAngle = angle;
+	m_inFixedStep = false;
+}
+
+// Blend the last tick's start and end values for rendering.  Each of
+// position and rotation is blended only if the fixed step moved it and
+// nothing has changed it since; otherwise the current value is drawn.
+void Object::updateRenderTransform(float alpha)
+{
+	bool blendPosition = position == m_tickEndPosition && !(position == m_tickStartPosition);
+	bool blendAngle = angle == m_tickEndAngle && !(angle == m_tickStartAngle);
+	m_renderPosition = blendPosition ? m_tickStartPosition + (position - m_tickStartPosition) * alpha : position;
+	m_renderAngle = angle;
+	if (blendAngle)
+	{
+		// Shortest way round, so 350 -> 10 turns 20 degrees, not 340
+		auto blend = [alpha](float from, float to) {
+			float delta = std::fmod(to - from + 540.0f, 360.0f) - 180.0f;
+			return from + delta * alpha;
+		};
+		m_renderAngle = Vector3(blend(m_tickStartAngle.x, angle.x),
+								blend(m_tickStartAngle.y, angle.y),
+								blend(m_tickStartAngle.z, angle.z));
+	}
+
+	m_renderInterpolated = blendPosition || blendAngle || (parent && parent->m_renderInterpolated);
+	if (m_renderInterpolated)
+	{
+		glm::mat4 local = localMatrix(m_renderPosition, m_renderAngle);
+		m_renderMatrix = parent ? parent->GetRenderMatrix() * local : local;
+	}
+	for (Object *child : children)
+		child->updateRenderTransform(alpha);
 }
 
 void Object::SetLayer(int newLayer)
@@ -162,6 +303,14 @@ void Object::update(float deltaTime)
 	this->deltatime = deltaTime;
 }
 
+void Object::fixedUpdate(float fixedDeltaTime)
+{
+	for (auto &component : components)
+	{
+		component->FixedUpdate(fixedDeltaTime);
+	}
+}
+
 void Object::lateUpdate(float deltaTime)
 {
 	for (auto &component : components)
@@ -237,6 +386,13 @@ Object *Object::CloneObject() const
 
 Object::~Object()
 {
+	SetParent(nullptr);
+	for (Object *child : children)
+	{
+		child->parent = nullptr;
+		child->markTransformDirty();
+	}
+	children.clear();
 	for (auto *component : components)
 	{
 		delete component;
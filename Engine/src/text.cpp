@@ -1,233 +1,75 @@
 #include "text.h"
 #include "object.h"
-#include "Renderer.h"
-#include "ArchiveUnpacker.h"
-#include "ResourceManager.h"
+#include "SpriteBatch.h"
 #include <GL/glew.h>
-#include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
-#include <iostream>
-#include "engine.h" // Assumes GetDefaultArchive() is available here
+#include <algorithm>
+#include <cmath>
 #include "Utils.h"  // If you need your Vector2, Color, etc.
 
-// ============================ Shaders ============================
-static const char *vertexShaderSource = R"(
-#version 330 core
-layout (location = 0) in vec2 aPos;
-layout (location = 1) in vec2 aTexCoord;
+static const char *kFontFile = "Roboto-Black.ttf";
 
-uniform mat4 model;
-uniform mat4 projection;
-
-out vec2 TexCoord;
-
-void main()
-{
-    gl_Position = projection * model * vec4(aPos, 0.0, 1.0);
-    TexCoord = aTexCoord;
-}
-)";
-
-static const char *fragmentShaderSource = R"(
-#version 330 core
-out vec4 FragColor;
-
-in vec2 TexCoord;
-
-uniform sampler2D textTexture;
-uniform vec4 textColor;
-
-void main()
-{
-    // Sample pixel color from texture
-    vec4 sampled = texture(textTexture, TexCoord);
-    // Multiply by textColor (can control opacity, etc.)
-    FragColor = sampled * textColor;
-}
-)";
-
-// ============================ Constructor/Destructor ============================
+// ============================ Constructor ============================
 TextComponent::TextComponent(int fontSize, const std::string &text, const Color &color, TextAlignment align)
-    : fontSize(fontSize), text(text), color(color), alignment(align), font(nullptr), textureID(0), textWidth(0), textHeight(0), VAO(0), VBO(0), EBO(0)
+    : fontSize(fontSize), text(text), color(color), alignment(align), atlas(nullptr), textWidth(0.0f), textHeight(0.0f)
 {
 }
 TextComponent::TextComponent(int fontSize, const std::string &text, TextAlignment align)
-    : fontSize(fontSize), text(text), color(Color(255, 255, 255, 255)), alignment(align), font(nullptr), textureID(0), textWidth(0), textHeight(0), VAO(0), VBO(0), EBO(0)
+    : fontSize(fontSize), text(text), color(Color(255, 255, 255, 255)), alignment(align), atlas(nullptr), textWidth(0.0f), textHeight(0.0f)
 {
 }
-TextComponent::~TextComponent()
-{
-    if (textureID)
-    {
-        glDeleteTextures(1, &textureID);
-    }
-    if (VAO)
-    {
-        glDeleteVertexArrays(1, &VAO);
-        glDeleteBuffers(1, &VBO);
-        glDeleteBuffers(1, &EBO);
-    }
-    if (font)
-    {
-        TTF_CloseFont(font);
-    }
-}
 
 // ============================ Initialization ============================
 void TextComponent::Init()
 {
-    // Load font from DefaultArchive
-    fontDataBuffer = Engine::GetDefaultArchive()->GetFile("Roboto-Black.ttf");
-    SDL_RWops *rw = SDL_RWFromConstMem(fontDataBuffer.data(), fontDataBuffer.size());
-    if (!rw)
-    {
-        std::cerr << "Failed to create SDL_RWops for font" << std::endl;
-        return;
-    }
-    font = TTF_OpenFontRW(rw, 1, fontSize);
-    if (!font)
-    {
-        std::cerr << "Failed to open font: " << TTF_GetError() << std::endl;
-        return;
-    }
-
-    // Create VAO/VBO/EBO for rendering (1x1 quad, then scale)
-    initRenderData();
-
-    // Create texture from text
-    updateTexture();
+    selectAtlas();
+    layout();
 }
 
-void TextComponent::initRenderData()
+// Atlases are shared and built the first time any label asks for them:
+// once per font in distance-field mode, once per (font, size) in bitmap mode.
+void TextComponent::selectAtlas()
 {
-    // Simple quad (0,0) -> (1,1), later scaled to text size
-    float vertices[] = {
-        // Position  // TexCoords
-        0.0f, 1.0f, 0.0f, 1.0f, // bottom-left
-        1.0f, 1.0f, 1.0f, 1.0f, // bottom-right
-        1.0f, 0.0f, 1.0f, 0.0f, // top-right
-        0.0f, 0.0f, 0.0f, 0.0f  // top-left
-    };
-
-    unsigned int indices[] = {
-        0, 1, 2,
-        2, 3, 0};
-
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
-
-    glBindVertexArray(VAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-    // Position
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void *)0);
-    glEnableVertexAttribArray(0);
-
-    // Texture coordinates
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void *)(2 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    glBindVertexArray(0);
+    atlas = renderMode == TextRenderMode::DistanceField
+        ? FontAtlas::GetDistanceField(kFontFile)
+        : FontAtlas::Get(kFontFile, fontSize);
 }
 
-// ============================ Create OpenGL texture from SDL_Surface ============================
-bool TextComponent::createTextureFromSurface(SDL_Surface *surface)
+// ============================ Layout ============================
+// Pure CPU: walk the string with the glyph advances.  No GL work.
+void TextComponent::layout()
 {
-    if (!surface)
-        return false;
-
-    // Delete old texture if present
-    if (textureID)
-    {
-        glDeleteTextures(1, &textureID);
-        textureID = 0;
-    }
-
-    textWidth = surface->w;
-    textHeight = surface->h;
-
-    // Determine format (prefer TTF_RenderText_Blended to get 32bpp RGBA)
-    GLenum format = GL_RGBA;
-    int bytesPerPixel = surface->format->BytesPerPixel;
-    if (bytesPerPixel == 4)
-    {
-        // Assume RGBA
-        format = GL_RGBA;
-    }
-    else
-    {
-        // Assume RGB
-        format = GL_RGB;
-    }
-
-    // Create OpenGL texture
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-
-    // Texture parameters
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    // Upload pixels to texture
-    glTexImage2D(GL_TEXTURE_2D, 0, format, textWidth, textHeight, 0, format,
-                 GL_UNSIGNED_BYTE, surface->pixels);
-
-    glBindTexture(GL_TEXTURE_2D, 0);
-
-    return true;
-}
-
-// ============================ Recreate text texture ============================
-void TextComponent::updateTexture()
-{
-    if (!font)
+    quads.clear();
+    textWidth = 0;
+    textHeight = 0;
+    if (!atlas)
         return;
 
-    // SDL_ttf may return 8bpp surface; use Blended to ensure RGBA32
-    SDL_Color sdlColor = {color.r, color.g, color.b, color.a};
-    SDL_Surface *surface = TTF_RenderText_Blended(font, text.c_str(), sdlColor);
-    if (!surface)
+    float scale = atlas->GetScale(fontSize);
+    float pen = 0.0f;
+    for (char c : text)
     {
-        std::cerr << "Failed to create text surface: " << TTF_GetError() << std::endl;
-        return;
+        const FontAtlas::Glyph &glyph = atlas->GetGlyph(c);
+        if (glyph.width > 0)
+            quads.push_back(GlyphQuad{pen + glyph.offsetX * scale, glyph.offsetY * scale,
+                                      glyph.width * scale, glyph.height * scale, &glyph});
+        pen += glyph.advance * scale;
     }
-
-    // Convert to RGBA32 (Byte order: RGBA)
-    SDL_Surface *convSurface = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
-    SDL_FreeSurface(surface); // Original surface no longer needed
-
-    if (!convSurface)
-    {
-        std::cerr << "SDL_ConvertSurfaceFormat failed: " << SDL_GetError() << std::endl;
-        return;
-    }
-
-    // Now convSurface->format->BytesPerPixel == 4 with RGBA channel order
-    // Safe to upload to OpenGL:
-    createTextureFromSurface(convSurface);
-
-    SDL_FreeSurface(convSurface);
+    textWidth = pen;
+    textHeight = atlas->GetLineHeight() * scale;
 }
 
 // ============================ Public methods ============================
 void TextComponent::setText(const std::string &newText)
 {
+    if (newText == text)
+        return;
     text = newText;
-    updateTexture();
+    layout();
 }
 
 void TextComponent::setColor(const Color &newColor)
 {
     color = newColor;
-    updateTexture();
 }
 
 void TextComponent::setAlignment(TextAlignment newAlignment)
@@ -235,23 +77,42 @@ void TextComponent::setAlignment(TextAlignment newAlignment)
     alignment = newAlignment;
 }
 
+void TextComponent::setFontSize(int newSize)
+{
+    fontSize = newSize;
+    if (!atlas)
+        return;
+    if (renderMode == TextRenderMode::Bitmap)
+        selectAtlas();
+    layout();
+}
+
+void TextComponent::setRenderMode(TextRenderMode newMode)
+{
+    renderMode = newMode;
+    if (!atlas)
+        return;
+    selectAtlas();
+    layout();
+}
+
+void TextComponent::setOutline(const Color &newOutlineColor, float width)
+{
+    outlineColor = newOutlineColor;
+    outlineWidth = width;
+}
+
 
 
 void TextComponent::Render()
 {
-    glDisable(GL_DEPTH_TEST);
-    // Nothing to draw if texture or VAO is missing
-    if (!textureID || !VAO)
+    if (quads.empty() || !atlas->GetTextureID())
         return;
 
-    // For simplicity, take position and angle from object
-    float angle = object->GetAngle().z;
-    Vector2 pos = object->GetPosition();
+    float angle = object->GetRenderWorldAngle().z;
+    Vector2 pos = object->GetRenderWorldPosition3D().toVector2();
     Vector2 size = object->GetSize();
 
-    // Compute model matrix
-    glm::mat4 model(1.0f);
-
     // Horizontal alignment:
     switch (alignment)
     {
@@ -267,48 +128,34 @@ void TextComponent::Render()
     // Vertically center within object
     pos.y += (size.y * 0.5f) - (textHeight * 0.5f);
 
-    model = glm::translate(model, glm::vec3(pos.x, pos.y, 0.0f));
-
-    model = glm::translate(model, glm::vec3(textWidth * 0.5f, textHeight * 0.5f, 0.0f));
-    model = glm::rotate(model, glm::radians(angle), glm::vec3(0, 0, 1));
-    model = glm::translate(model, glm::vec3(-textWidth * 0.5f, -textHeight * 0.5f, 0.0f));
-
-    model = glm::scale(model, glm::vec3(textWidth, textHeight, 1.0f));
+    // The line rotates about its centre: each glyph centre is rotated around
+    // it, and SpriteBatch turns the glyph quad itself by the same angle.
+    float rad = glm::radians(angle);
+    float c = std::cos(rad), s = std::sin(rad);
+    glm::vec2 centre(pos.x + textWidth * 0.5f, pos.y + textHeight * 0.5f);
+    glm::vec4 tint(color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, color.a / 255.0f);
+    GLuint texture = atlas->GetTextureID();
 
-    glm::mat4 projection = Renderer::Get().GetOrthoProjection();
-
-    GLuint prog = ResourceManager::Get().GetOrCreateShader("text", vertexShaderSource, fragmentShaderSource);
-    glUseProgram(prog);
-
-    struct Uniforms {
-        GLint model, projection, textColor, textTexture;
-    };
-    static std::unordered_map<GLuint, Uniforms> uniformCache;
-    auto it = uniformCache.find(prog);
-    if (it == uniformCache.end()) {
-        Uniforms u;
-        u.model = glGetUniformLocation(prog, "model");
-        u.projection = glGetUniformLocation(prog, "projection");
-        u.textColor = glGetUniformLocation(prog, "textColor");
-        u.textTexture = glGetUniformLocation(prog, "textTexture");
-        uniformCache[prog] = u;
-        it = uniformCache.find(prog);
+    SpriteBatch::Style style;
+    if (atlas->IsDistanceField())
+    {
+        style.distanceField = true;
+        // Pixels on screen -> distance units: one atlas pixel is 0.5 / spread
+        float scale = atlas->GetScale(fontSize);
+        style.outlineWidth = std::min(outlineWidth / scale * 0.5f / atlas->GetSpread(), 0.49f);
+        style.outlineColor = glm::vec4(outlineColor.r / 255.0f, outlineColor.g / 255.0f,
+                                       outlineColor.b / 255.0f, outlineColor.a / 255.0f);
     }
-    const Uniforms& u = it->second;
-
-    glUniformMatrix4fv(u.model, 1, GL_FALSE, glm::value_ptr(model));
-    glUniformMatrix4fv(u.projection, 1, GL_FALSE, glm::value_ptr(projection));
-
-    glUniform4f(u.textColor, color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, color.a / 255.0f);
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glUniform1i(u.textTexture, 0);
-
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
-
-    glBindTexture(GL_TEXTURE_2D, 0);
-    glUseProgram(0);
-}
\ No newline at end of file
+    SpriteBatch &batch = SpriteBatch::Get();
+    for (const GlyphQuad &quad : quads)
+    {
+        const FontAtlas::Glyph &g = *quad.glyph;
+        glm::vec2 half(quad.w * 0.5f, quad.h * 0.5f);
+        float lx = quad.x + half.x - textWidth * 0.5f;
+        float ly = quad.y + half.y - textHeight * 0.5f;
+        glm::vec2 glyphCentre = centre + glm::vec2(lx * c - ly * s, lx * s + ly * c);
+        batch.Draw(texture, glyphCentre - half, glm::vec2(quad.w, quad.h), angle,
+                   tint, glm::vec4(g.u0, g.v0, g.u1, g.v1), style);
+    }
+}
@@ -0,0 +1,78 @@
+// ---------------------------------------------------------------------------
+//  ChangedBoundsTest — checks what VoxelRenderer reports to the shadow cache
+//  through TakeChangedBounds().
+//
+//  Runs on the null backend (no window, no GL), so the renderer keeps
+//  buffer-less mesh groups and only its bookkeeping is exercised.
+//
+//  Build & run:   make test      (prints one line per check, exit code 1 on failure)
+// ---------------------------------------------------------------------------
+
+#include "VoxelRenderer.h"
+#include "RenderThread.h"
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+int g_failures = 0;
+
+void check(bool ok, const char* what)
+{
+    std::printf("%s  %s\n", ok ? "ok  " : "FAIL", what);
+    if (!ok) ++g_failures;
+}
+
+// One texture group with a single triangle, for a chunk at (cx, cz)
+void loadChunk(VoxelRenderer& renderer, int cx, int cz)
+{
+    std::vector<VoxelMeshData> meshes(1);
+    meshes[0].vertices.assign(3 * 8, 0.0f);
+    meshes[0].indices = {0, 1, 2};
+    glm::vec3 mn(cx * 16.0f, 0.0f, cz * 16.0f);
+    renderer.UpdateChunk(cx, cz, mn, mn + glm::vec3(16.0f, 64.0f, 16.0f), meshes);
+}
+
+} // namespace
+
+int main()
+{
+    RenderThread::Get().SetNullBackend(true);
+    VoxelRenderer& renderer = VoxelRenderer::Get();
+    std::vector<IVoxelRenderer::Bounds> bounds;
+
+    loadChunk(renderer, 0, 0);
+    loadChunk(renderer, 1, 0);
+    bool all = renderer.TakeChangedBounds(bounds);
+    check(!all && bounds.size() == 2, "loaded chunks are reported one box each");
+
+    all = renderer.TakeChangedBounds(bounds);
+    check(!all && bounds.empty(), "nothing is reported twice");
+
+    loadChunk(renderer, 0, 0);
+    all = renderer.TakeChangedBounds(bounds);
+    check(!all && bounds.size() == 1 && bounds[0].min.x == 0.0f && bounds[0].max.x == 16.0f,
+          "a rebuilt chunk reports its own box");
+
+    // Clear, then reload somewhere else before the shadow cache looks: the
+    // removed chunks are gone from the tree, so only a full redraw is safe.
+    renderer.Clear();
+    loadChunk(renderer, 5, 5);
+    all = renderer.TakeChangedBounds(bounds);
+    check(all && bounds.empty(), "clear then reload asks for a full redraw");
+
+    all = renderer.TakeChangedBounds(bounds);
+    check(!all && bounds.empty(), "the full redraw is reported once");
+
+    renderer.Clear();
+    all = renderer.TakeChangedBounds(bounds);
+    check(all && bounds.empty(), "clear with nothing reloaded asks for a full redraw");
+
+    loadChunk(renderer, 2, 3);
+    all = renderer.TakeChangedBounds(bounds);
+    check(!all && bounds.size() == 1, "tracking resumes after a full redraw");
+
+    renderer.Clear();
+    std::printf("%s\n", g_failures ? "FAILED" : "all passed");
+    return g_failures ? 1 : 0;
+}
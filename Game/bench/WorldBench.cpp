@@ -0,0 +1,189 @@
+// ---------------------------------------------------------------------------
+//  WorldBench — headless voxel world streaming benchmark.
+//
+//  Drives VoxelWorld (generation + meshing, no window, no GL) along a
+//  scripted camera path and prints one JSON object with throughput, mesh
+//  size, peak memory and per-stage latency percentiles.
+//
+//  Build & run:   make bench && ./world_bench --distance 8 --seed 1234
+//  Options:
+//      --distance N   render distance in chunks          (default 8)
+//      --seed S       terrain seed                        (default 1337)
+//      --frames F     number of simulated frames          (default 2000)
+//      --speed V      camera speed in blocks per frame    (default 0.5)
+//      --path P       line | circle | zigzag              (default line)
+// ---------------------------------------------------------------------------
+
+#include "VoxelWorld.h"
+#include <sys/resource.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+/// Mesh sink that only measures what the renderer would have uploaded.
+class CountingSink : public IChunkMeshSink {
+public:
+    size_t bodyUploads = 0;
+    size_t partUploads = 0;
+    size_t vertices = 0;
+    size_t indices = 0;
+
+    void UpdateChunk(int, int, const glm::vec3&, const glm::vec3&, std::vector<VoxelMeshData>& meshes) override {
+        ++bodyUploads;
+        consume(meshes);
+    }
+    void UpdateChunkPart(int, int, int, std::vector<VoxelMeshData>& meshes) override {
+        ++partUploads;
+        consume(meshes);
+    }
+    void RemoveChunk(int, int) override {}
+
+private:
+    void consume(std::vector<VoxelMeshData>& meshes) {
+        for (auto& md : meshes) {
+            vertices += md.vertices.size() / 8;
+            indices += md.indices.size();
+            // Same contract as VoxelRenderer: empty but keep capacity.
+            md.vertices.clear();
+            md.indices.clear();
+        }
+    }
+};
+
+struct Options {
+    int distance = 8;
+    unsigned int seed = 1337;
+    int frames = 2000;
+    float speed = 0.5f;
+    std::string path = "line";
+};
+
+bool parseArgs(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (!v) { std::fprintf(stderr, "missing value for %s\n", a); return false; }
+        if      (!std::strcmp(a, "--distance")) opt.distance = std::atoi(v);
+        else if (!std::strcmp(a, "--seed"))     opt.seed = (unsigned int)std::strtoul(v, nullptr, 10);
+        else if (!std::strcmp(a, "--frames"))   opt.frames = std::atoi(v);
+        else if (!std::strcmp(a, "--speed"))    opt.speed = (float)std::atof(v);
+        else if (!std::strcmp(a, "--path"))     opt.path = v;
+        else { std::fprintf(stderr, "unknown option %s\n", a); return false; }
+        ++i;
+    }
+    if (opt.path != "line" && opt.path != "circle" && opt.path != "zigzag") {
+        std::fprintf(stderr, "unknown path %s\n", opt.path.c_str());
+        return false;
+    }
+    return opt.distance > 0 && opt.frames > 0;
+}
+
+/// Camera position (in blocks) at a given frame of the scripted path.
+void cameraAt(const Options& opt, int frame, float& x, float& z) {
+    float d = frame * opt.speed;
+    if (opt.path == "circle") {
+        float r = (opt.distance + 4) * (float)CHUNK_SIZE;
+        float a = d / r;
+        x = r * std::cos(a) - r;
+        z = r * std::sin(a);
+    } else if (opt.path == "zigzag") {
+        float leg = 4.0f * CHUNK_SIZE;
+        float t = std::fmod(d, 2.0f * leg);
+        x = d * 0.7071f;
+        z = (t < leg ? t : 2.0f * leg - t);
+    } else {
+        x = d;
+        z = 0.0f;
+    }
+}
+
+double percentile(std::vector<double>& v, double p) {
+    if (v.empty()) return 0.0;
+    size_t k = (size_t)std::min<double>(v.size() - 1, std::floor(p * (v.size() - 1) + 0.5));
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+double peakRssMB() {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+#ifdef __APPLE__
+    return ru.ru_maxrss / (1024.0 * 1024.0);   // bytes
+#else
+    return ru.ru_maxrss / 1024.0;              // kilobytes
+#endif
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        std::fprintf(stderr, "usage: world_bench [--distance N] [--seed S] [--frames F] [--speed V] [--path line|circle|zigzag]\n");
+        return 1;
+    }
+
+    CountingSink sink;
+    std::vector<double> samples[VoxelWorld::StageCount];
+    double stageTotal[VoxelWorld::StageCount] = {};
+
+    VoxelWorld world;
+    world.SetSeed(opt.seed);
+    world.SetRenderDistance(opt.distance);
+    world.SetMeshSink(&sink);
+    world.SetStageTimer([&](VoxelWorld::Stage s, double sec) {
+        samples[s].push_back(sec);
+        stageTotal[s] += sec;
+    });
+
+    std::vector<double> frameTimes;
+    frameTimes.reserve(opt.frames);
+    auto start = std::chrono::steady_clock::now();
+    for (int f = 0; f < opt.frames; ++f) {
+        float x, z;
+        cameraAt(opt, f, x, z);
+        auto t0 = std::chrono::steady_clock::now();
+        world.Update((int)std::floor(x), (int)std::floor(z));
+        std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t0;
+        frameTimes.push_back(dt.count());
+    }
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+
+    const size_t generated = samples[VoxelWorld::StageGenerate].size();
+    const size_t meshed = samples[VoxelWorld::StageMesh].size();
+    const VoxelWorld::AllocationStats alloc = world.GetAllocationStats();
+    auto rate = [](size_t n, double sec) { return sec > 0.0 ? n / sec : 0.0; };
+    const char* names[VoxelWorld::StageCount] = {"generate", "mesh", "border"};
+
+    std::printf("{\n");
+    std::printf("  \"config\": {\"distance\": %d, \"seed\": %u, \"frames\": %d, \"speed\": %.3f, \"path\": \"%s\"},\n",
+                opt.distance, opt.seed, opt.frames, opt.speed, opt.path.c_str());
+    std::printf("  \"wall_seconds\": %.6f,\n", wall.count());
+    std::printf("  \"chunks_generated\": %zu,\n", generated);
+    std::printf("  \"chunks_meshed\": %zu,\n", meshed);
+    std::printf("  \"border_rebuilds\": %zu,\n", samples[VoxelWorld::StageBorder].size());
+    std::printf("  \"chunks_per_sec_generated\": %.2f,\n", rate(generated, stageTotal[VoxelWorld::StageGenerate]));
+    std::printf("  \"chunks_per_sec_meshed\": %.2f,\n", rate(meshed, stageTotal[VoxelWorld::StageMesh]));
+    std::printf("  \"vertices_per_chunk\": %.1f,\n", sink.bodyUploads ? (double)sink.vertices / sink.bodyUploads : 0.0);
+    std::printf("  \"loaded_chunks\": %zu,\n", world.LoadedChunkCount());
+    std::printf("  \"peak_rss_mb\": %.2f,\n", peakRssMB());
+    std::printf("  \"allocations\": {\"chunk_heap\": %zu, \"chunk_reuse\": %zu, \"block_heap\": %zu, \"block_reuse\": %zu, \"scratch_growth\": %zu},\n",
+                alloc.chunkHeapAllocs, alloc.chunkReuses, alloc.blockHeapAllocs, alloc.blockReuses, alloc.scratchGrowths);
+    std::printf("  \"latency_ms\": {\n");
+    for (int s = 0; s < VoxelWorld::StageCount; ++s) {
+        std::printf("    \"%s\": {\"p50\": %.4f, \"p99\": %.4f},\n", names[s],
+                    percentile(samples[s], 0.50) * 1000.0, percentile(samples[s], 0.99) * 1000.0);
+    }
+    std::printf("    \"frame\": {\"p50\": %.4f, \"p99\": %.4f}\n",
+                percentile(frameTimes, 0.50) * 1000.0, percentile(frameTimes, 0.99) * 1000.0);
+    std::printf("  }\n");
+    std::printf("}\n");
+    return 0;
+}
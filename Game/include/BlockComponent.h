@@ -3,14 +3,7 @@
 #include "object.h"
 #include "Model3DComponent.h"
 #include "BoxCollider3D.h"
-
-enum class BlockType {
-	Dirt,
-	Stone,
-	Grass,
-	Sand,
-	Wood
-};
+#include "BlockType.h"
 
 class BlockComponent : public Component {
 public:
@@ -0,0 +1,13 @@
+#pragma once
+
+// Block kinds stored in the voxel world.  Kept in its own header so the
+// chunk storage / mesher can be used without pulling in any GL headers.
+enum class BlockType {
+	Dirt,
+	Stone,
+	Grass,
+	Sand,
+	Wood
+};
+
+static constexpr int kBlockTypeCount = 5;
@@ -0,0 +1,221 @@
+#pragma once
+#include "BlockType.h"
+#include "PoolAllocator.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+// ============================================================================
+//  Copy-on-write chunk block storage
+//
+//  A chunk column is split into vertical sections of 16x16x16 cells.  The
+//  published state of a chunk is an immutable ChunkData (generation number +
+//  one shared pointer per section).  Readers on any thread grab a
+//  ChunkSnapshot, which is just a reference-counted handle to that state, and
+//  can keep reading it while the owning thread keeps editing the chunk.
+//
+//  Writers never touch published data: an edit clones the ChunkData (a few
+//  pointer copies) plus only the touched section, then atomically publishes
+//  the new version with generation + 1.  Untouched sections stay shared
+//  between the old and new versions.
+//
+//  Threading contract: Snapshot() may be called from any thread.  All other
+//  ChunkStorage methods belong to the single owning (main) thread.
+//
+//  Sections and versions come from PoolAllocator free lists, so streaming
+//  chunks in and out recycles their storage instead of hitting the heap.
+// ============================================================================
+
+static constexpr int CHUNK_SIZE = 16;
+static constexpr int CHUNK_SECTION_HEIGHT = 16;
+static constexpr int CHUNK_SECTIONS = 8;
+// World height limit: blocks exist only at 0 <= gy < CHUNK_HEIGHT (128).
+// The section array is fixed, so VoxelWorld::SetBlock refuses anything
+// higher and terrain generation is clamped to it.  Raise CHUNK_SECTIONS
+// for taller worlds (each section costs one pointer per chunk while empty).
+static constexpr int CHUNK_HEIGHT = CHUNK_SECTION_HEIGHT * CHUNK_SECTIONS;
+
+// ---- One 16x16x16 section ---------------------------------------------------
+struct ChunkSection {
+	static constexpr int kCells = CHUNK_SIZE * CHUNK_SIZE * CHUNK_SECTION_HEIGHT;
+
+	// 0 = air, otherwise (BlockType + 1)
+	std::array<uint8_t, kCells> cells{};
+	int solidCount = 0;
+
+	static int index(int lx, int sy, int lz) {
+		return (sy << 8) | (lz << 4) | lx;
+	}
+	static uint8_t encode(BlockType t) { return (uint8_t)((int)t + 1); }
+	static BlockType decode(uint8_t c) { return (BlockType)(c - 1); }
+};
+
+// ---- Immutable published version of a chunk ---------------------------------
+struct ChunkData {
+	uint64_t generation = 0;
+	int blockCount = 0;
+	// nullptr = section is entirely air
+	std::array<std::shared_ptr<const ChunkSection>, CHUNK_SECTIONS> sections;
+};
+
+// ---- Read-only handle, safe to hold on any thread ----------------------------
+class ChunkSnapshot {
+public:
+	ChunkSnapshot() = default;
+	explicit ChunkSnapshot(std::shared_ptr<const ChunkData> d) : data(std::move(d)) {}
+
+	bool Valid() const { return data != nullptr; }
+	bool Empty() const { return !data || data->blockCount == 0; }
+	uint64_t Generation() const { return data ? data->generation : 0; }
+
+	const ChunkSection* Section(int s) const {
+		return data ? data->sections[s].get() : nullptr;
+	}
+
+	bool Has(int lx, int ly, int lz) const {
+		if (ly < 0 || ly >= CHUNK_HEIGHT) return false;
+		const ChunkSection* sec = Section(ly / CHUNK_SECTION_HEIGHT);
+		return sec && sec->cells[ChunkSection::index(lx, ly % CHUNK_SECTION_HEIGHT, lz)] != 0;
+	}
+
+	bool Get(int lx, int ly, int lz, BlockType& out) const {
+		if (ly < 0 || ly >= CHUNK_HEIGHT) return false;
+		const ChunkSection* sec = Section(ly / CHUNK_SECTION_HEIGHT);
+		if (!sec) return false;
+		uint8_t c = sec->cells[ChunkSection::index(lx, ly % CHUNK_SECTION_HEIGHT, lz)];
+		if (c == 0) return false;
+		out = ChunkSection::decode(c);
+		return true;
+	}
+
+	/// Visit every solid block: fn(lx, ly, lz, BlockType).  Empty sections
+	/// are skipped without touching their cells.
+	template <typename Fn>
+	void ForEachBlock(Fn&& fn) const {
+		if (!data) return;
+		for (int s = 0; s < CHUNK_SECTIONS; ++s) {
+			const ChunkSection* sec = data->sections[s].get();
+			if (!sec || sec->solidCount == 0) continue;
+			int baseY = s * CHUNK_SECTION_HEIGHT;
+			for (int i = 0; i < ChunkSection::kCells; ++i) {
+				uint8_t c = sec->cells[i];
+				if (c == 0) continue;
+				fn(i & 0xF, baseY + (i >> 8), (i >> 4) & 0xF, ChunkSection::decode(c));
+			}
+		}
+	}
+
+private:
+	std::shared_ptr<const ChunkData> data;
+};
+
+// ---- Owner-side storage ------------------------------------------------------
+class ChunkStorage {
+public:
+	ChunkStorage() : current(newData()) {}
+
+	/// Cheap, thread-safe: bumps a reference count on the current version.
+	ChunkSnapshot Snapshot() const {
+		return ChunkSnapshot(std::atomic_load(&current));
+	}
+
+	/// Drop all blocks (used when a pooled chunk is recycled).  Readers that
+	/// still hold a snapshot keep the old data alive until they release it.
+	void Reset() {
+		publish(newData());
+	}
+
+	uint64_t Generation() const { return current->generation; }
+	bool Empty() const { return current->blockCount == 0; }
+
+	// Owner-thread reads go straight to the current version (only the owner
+	// ever replaces it, so no synchronisation is needed here).
+	bool Has(int lx, int ly, int lz) const { return ChunkSnapshot(current).Has(lx, ly, lz); }
+	bool Get(int lx, int ly, int lz, BlockType& out) const { return ChunkSnapshot(current).Get(lx, ly, lz, out); }
+
+	/// Set a single block.  Clones only the touched section.
+	/// Returns false if the cell already held that block or is out of range.
+	bool Set(int lx, int ly, int lz, BlockType type) {
+		return writeCell(lx, ly, lz, ChunkSection::encode(type));
+	}
+
+	/// Clear a single block.  Returns false if the cell was already air.
+	bool Erase(int lx, int ly, int lz) {
+		return writeCell(lx, ly, lz, 0);
+	}
+
+	// ---- Batched writes (terrain generation) ----------------------------------
+	/// Accumulates edits into private copies of the touched sections and
+	/// publishes them as one new generation on Commit().
+	class BatchWriter {
+	public:
+		explicit BatchWriter(ChunkStorage& s) : storage(s) {}
+
+		void Set(int lx, int ly, int lz, BlockType type) {
+			if (ly < 0 || ly >= CHUNK_HEIGHT) return;
+			int s = ly / CHUNK_SECTION_HEIGHT;
+			if (!edited[s]) {
+				const auto& src = storage.current->sections[s];
+				edited[s] = src ? newSection(*src) : newSection();
+			}
+			uint8_t& cell = edited[s]->cells[ChunkSection::index(lx, ly % CHUNK_SECTION_HEIGHT, lz)];
+			if (cell == 0) edited[s]->solidCount++;
+			cell = ChunkSection::encode(type);
+		}
+
+		void Commit() {
+			auto next = newData(*storage.current);
+			for (int s = 0; s < CHUNK_SECTIONS; ++s) {
+				if (!edited[s]) continue;
+				int before = next->sections[s] ? next->sections[s]->solidCount : 0;
+				next->blockCount += edited[s]->solidCount - before;
+				next->sections[s] = std::move(edited[s]);
+			}
+			storage.publish(std::move(next));
+		}
+
+	private:
+		ChunkStorage& storage;
+		std::array<std::shared_ptr<ChunkSection>, CHUNK_SECTIONS> edited;
+	};
+
+private:
+	bool writeCell(int lx, int ly, int lz, uint8_t value) {
+		if (ly < 0 || ly >= CHUNK_HEIGHT) return false;
+		int s = ly / CHUNK_SECTION_HEIGHT;
+		int idx = ChunkSection::index(lx, ly % CHUNK_SECTION_HEIGHT, lz);
+		const auto& src = current->sections[s];
+		uint8_t old = src ? src->cells[idx] : 0;
+		if (old == value) return false;
+
+		auto sec = src ? newSection(*src) : newSection();
+		sec->cells[idx] = value;
+		int delta = (value != 0 ? 1 : 0) - (old != 0 ? 1 : 0);
+		sec->solidCount += delta;
+
+		auto next = newData(*current);
+		next->blockCount += delta;
+		if (sec->solidCount == 0) next->sections[s].reset();
+		else next->sections[s] = std::move(sec);
+		publish(std::move(next));
+		return true;
+	}
+
+	template <typename... Args>
+	static std::shared_ptr<ChunkSection> newSection(Args&&... args) {
+		return std::allocate_shared<ChunkSection>(PoolAllocator<ChunkSection>(), std::forward<Args>(args)...);
+	}
+	template <typename... Args>
+	static std::shared_ptr<ChunkData> newData(Args&&... args) {
+		return std::allocate_shared<ChunkData>(PoolAllocator<ChunkData>(), std::forward<Args>(args)...);
+	}
+
+	void publish(std::shared_ptr<ChunkData> next) {
+		next->generation = current->generation + 1;
+		std::atomic_store(&current, std::shared_ptr<const ChunkData>(std::move(next)));
+	}
+
+	std::shared_ptr<const ChunkData> current;
+};
@@ -2,6 +2,7 @@
 #define HotbarComponent_H
 #include "component.h" 
 #include "BlockComponent.h" 
+#include "ResourceManager.h"
 
 
 class HotbarComponent : public Component
@@ -15,6 +16,8 @@ private:
     BlockType selectedSlot = BlockType::Grass;
     int selectedSlotIndex = 0;
     std::vector<Object*> hotbarSlots;
+    TextureHandle slotTexture;
+    TextureHandle selectedSlotTexture;
 }; 
 
 #endif // HotbarComponent_H
\ No newline at end of file
@@ -18,7 +18,7 @@ class HotbarComponent;
 //
 // The owning Object is an invisible "body" that only carries position and a
 // collider (no visible model).  The attached CameraComponent's owning Object
-// is moved to match the player's eye position every frame.
+// is moved to match the player's eye position every fixed step.
 //
 // Responsibilities:
 //   • WASD movement relative to camera yaw (horizontal only)
@@ -56,6 +56,7 @@ public:
 	}
 
 	void Update(float dt) override;
+	void FixedUpdate(float dt) override;
 
 	// --- Input events -------------------------------------------------------
 
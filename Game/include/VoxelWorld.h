@@ -0,0 +1,678 @@
+#pragma once
+#include "BlockType.h"
+#include "ChunkStorage.h"
+#include "PoolAllocator.h"
+#include "VoxelMeshData.h"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+// ============================================================================
+//  VoxelWorld — GL-free core of the chunked voxel world.
+//
+//  Owns block storage, terrain generation, chunk streaming and meshing.  It
+//  knows nothing about objects, scenes or OpenGL: finished meshes are pushed
+//  through an IChunkMeshSink (VoxelRenderer in game, a counting sink in the
+//  world benchmark).  All coordinates here are integer grid coordinates.
+//
+//  WorldGridComponent wraps one of these and adds camera tracking, world
+//  space conversion and the block highlight.
+// ============================================================================
+
+// ---- Chunk coordinate key --------------------------------------------------
+struct ChunkCoord {
+	int cx, cz;
+	bool operator==(const ChunkCoord& o) const { return cx == o.cx && cz == o.cz; }
+};
+struct ChunkCoordHash {
+	size_t operator()(const ChunkCoord& c) const {
+		return std::hash<long long>()(((long long)c.cx << 32) | (unsigned int)c.cz);
+	}
+};
+
+// ---- Single chunk ----------------------------------------------------------
+struct Chunk {
+	ChunkCoord coord;
+	// Block data — copy-on-write sections, snapshot-readable from any thread.
+	ChunkStorage storage;
+	bool generated = false;
+	bool meshDirty = true;
+	// Border strips (bit per side) that need their faces regenerated.
+	uint8_t borderDirty = 0;
+	// Sides whose neighbour was not loaded at the last mesh build — their
+	// border strips still hold faces a newly loaded neighbour may hide.
+	uint8_t missingNeighbours = 0;
+
+	/// Return to the freshly constructed state so the chunk can be reused.
+	void Reset() {
+		storage.Reset();
+		generated = false;
+		meshDirty = true;
+		borderDirty = 0;
+		missingNeighbours = 0;
+	}
+};
+
+// ============================================================================
+//  VoxelWorld
+// ============================================================================
+class VoxelWorld {
+public:
+	/// Pipeline stages reported to the stage timer.
+	enum Stage { StageGenerate = 0, StageMesh, StageBorder, StageCount };
+	using StageTimer = std::function<void(Stage, double seconds)>;
+
+	VoxelWorld()
+		: blockSize(20.0f / 35.0f)
+		, renderDistance(4)
+		, worldSeed(std::random_device{}())
+		, baseHeight(3)
+		, maxHillHeight(6)
+		, surfaceType(BlockType::Dirt)
+		, undergroundType(BlockType::Stone)
+		, lastPlayerCx(INT_MAX)
+		, lastPlayerCz(INT_MAX)
+	{}
+
+	~VoxelWorld() {
+		for (auto& kv : chunks) delete kv.second;
+		chunks.clear();
+		for (Chunk* c : chunkPool) delete c;
+		chunkPool.clear();
+	}
+
+	VoxelWorld(const VoxelWorld&) = delete;
+	VoxelWorld& operator=(const VoxelWorld&) = delete;
+
+	// ---- Configuration -----------------------------------------------------
+	void SetMeshSink(IChunkMeshSink* s) { sink = s; }
+	/// Texture id written into VoxelMeshData::textureId for a block type.
+	void SetTypeTexture(BlockType t, unsigned int textureId) {
+		int i = (int)t;
+		if (i >= 0 && i < kBlockTypeCount) typeTextures[i] = textureId;
+	}
+	/// Optional: called with the duration of every generate / mesh / border
+	/// step.  Leave unset in game so no clocks are read.
+	void SetStageTimer(StageTimer t) { stageTimer = std::move(t); }
+
+	void SetBlockSize(float s)  { blockSize = s; }
+	void SetRenderDistance(int n) { renderDistance = n; }
+	void SetSeed(unsigned int s) { worldSeed = s; }
+	void SetTerrainParams(int base, int hill, BlockType surface, BlockType underground) {
+		baseHeight = base; maxHillHeight = hill;
+		surfaceType = surface; undergroundType = underground;
+	}
+	float GetBlockSize() const { return blockSize; }
+	int GetRenderDistance() const { return renderDistance; }
+
+	// ---- Allocation counters -----------------------------------------------
+	/// Heap allocations vs. recycled objects on the streaming path.  Once the
+	/// player has walked around for a bit every "Reuses" counter should keep
+	/// climbing while the "HeapAllocs" ones stay flat.
+	struct AllocationStats {
+		size_t chunkHeapAllocs = 0;  // Chunk objects created with new
+		size_t chunkReuses = 0;      // Chunk objects taken from the pool
+		size_t blockHeapAllocs = 0;  // section/version/map-node blocks from the heap
+		size_t blockReuses = 0;      // ... recycled from the pool free lists
+		size_t scratchGrowths = 0;   // mesh scratch buffers that had to grow
+	};
+	AllocationStats GetAllocationStats() const {
+		AllocationStats s;
+		s.chunkHeapAllocs = chunkHeapAllocs;
+		s.chunkReuses = chunkReuses;
+		s.blockHeapAllocs = GetPoolAllocatorStats().heapAllocations.load();
+		s.blockReuses = GetPoolAllocatorStats().reusedAllocations.load();
+		s.scratchGrowths = meshScratch().growths;
+		return s;
+	}
+
+	// ---- Block access (global grid coords) ---------------------------------
+
+	/// Check if a solid block exists at global grid coords.
+	bool HasBlock(int gx, int gy, int gz) const {
+		int cx, cz, lx, lz;
+		GlobalToChunk(gx, gz, cx, cz, lx, lz);
+		auto it = chunks.find({cx, cz});
+		if (it == chunks.end() || !it->second->generated) return false;
+		return it->second->storage.Has(lx, gy, lz);
+	}
+
+	BlockType GetBlockType(int gx, int gy, int gz) const {
+		int cx, cz, lx, lz;
+		GlobalToChunk(gx, gz, cx, cz, lx, lz);
+		auto it = chunks.find({cx, cz});
+		BlockType type = BlockType::Dirt;
+		if (it != chunks.end()) it->second->storage.Get(lx, gy, lz, type);
+		return type;
+	}
+
+	/// Place a block.  Returns false if already occupied or out of range
+	/// (gy outside [0, CHUNK_HEIGHT), see ChunkStorage.h).
+	bool SetBlock(int gx, int gy, int gz, BlockType type) {
+		if (gy < 0 || gy >= CHUNK_HEIGHT || HasBlock(gx, gy, gz)) return false;
+		int cx, cz, lx, lz;
+		GlobalToChunk(gx, gz, cx, cz, lx, lz);
+		Chunk* chunk = getOrCreateChunk(cx, cz);
+		chunk->storage.Set(lx, gy, lz, type);
+		chunk->meshDirty = true;
+		markNeighborChunksDirty(gx, gz);
+		return true;
+	}
+
+	/// Remove a block.  Returns false if there was none.
+	bool RemoveBlock(int gx, int gy, int gz) {
+		int cx, cz, lx, lz;
+		GlobalToChunk(gx, gz, cx, cz, lx, lz);
+		auto it = chunks.find({cx, cz});
+		if (it == chunks.end()) return false;
+		if (!it->second->storage.Erase(lx, gy, lz)) return false;
+		it->second->meshDirty = true;
+		markNeighborChunksDirty(gx, gz);
+		return true;
+	}
+
+	/// Immutable, reference-counted view of a chunk's blocks.  Safe to hand
+	/// to background consumers (meshing, saving, pathfinding) while the main
+	/// thread keeps editing the world.  Invalid if the chunk is not loaded.
+	ChunkSnapshot GetChunkSnapshot(int cx, int cz) const {
+		auto it = chunks.find({cx, cz});
+		if (it == chunks.end() || !it->second->generated) return ChunkSnapshot();
+		return it->second->storage.Snapshot();
+	}
+
+	int GetTerrainHeight(int gx, int gz) const {
+		float v1 = sampleNoise(gx, gz, 8, worldSeed);
+		float v2 = sampleNoise(gx, gz, 4, worldSeed * 2u + 137u);
+		float v3 = sampleNoise(gx, gz, 2, worldSeed * 3u + 5449u);
+		float combined = v1 * 0.6f + v2 * 0.25f + v3 * 0.15f;
+		return std::max(1, baseHeight + (int)(combined * maxHillHeight));
+	}
+
+	/// Generate and mesh the chunks around a grid position right now,
+	/// bypassing the per-frame budgets.
+	void ForceGenerateArea(int gx, int gz, int radiusChunks = 1) {
+		int cx, cz, lx, lz;
+		GlobalToChunk(gx, gz, cx, cz, lx, lz);
+		for (int dz = -radiusChunks; dz <= radiusChunks; ++dz)
+			for (int dx = -radiusChunks; dx <= radiusChunks; ++dx)
+				generateChunk(cx + dx, cz + dz);
+		for (int dz = -radiusChunks; dz <= radiusChunks; ++dz)
+			for (int dx = -radiusChunks; dx <= radiusChunks; ++dx) {
+				auto it = chunks.find({cx + dx, cz + dz});
+				if (it != chunks.end() && it->second->meshDirty)
+					buildChunkMesh(it->second);
+			}
+	}
+
+	// ---- Streaming ---------------------------------------------------------
+
+	/// One frame of streaming around the viewer: queue/unload chunks, then
+	/// spend the per-frame generation and meshing budgets.
+	void Update(int viewerGx, int viewerGz) {
+		StreamAround(viewerGx, viewerGz);
+		ProcessGenerationQueue();
+		RebuildDirtyMeshes();
+	}
+
+	/// Queue missing chunks within render distance of the viewer and unload
+	/// the ones that fell out of range.  Cheap unless the viewer changed chunk.
+	void StreamAround(int viewerGx, int viewerGz) {
+		int cx, cz, lx, lz;
+		GlobalToChunk(viewerGx, viewerGz, cx, cz, lx, lz);
+		if (cx == lastPlayerCx && cz == lastPlayerCz) return;
+		lastPlayerCx = cx; lastPlayerCz = cz;
+		for (int dz = -renderDistance; dz <= renderDistance; ++dz)
+			for (int dx = -renderDistance; dx <= renderDistance; ++dx) {
+				auto it = chunks.find({cx + dx, cz + dz});
+				if (it == chunks.end() || !it->second->generated)
+					enqueueChunk(cx + dx, cz + dz);
+			}
+		int unloadDist = renderDistance + 2;
+		toUnload.clear();
+		for (auto& kv : chunks) {
+			int ddx = kv.first.cx - cx, ddz = kv.first.cz - cz;
+			if (std::abs(ddx) > unloadDist || std::abs(ddz) > unloadDist)
+				toUnload.push_back(kv.first);
+		}
+		for (auto& cc : toUnload) unloadChunk(cc.cx, cc.cz);
+	}
+
+	// The queue is a vector consumed from queueHead; it is compacted only
+	// once drained so its storage is reused across streaming bursts.
+	/// Generate up to `maxChunks` queued chunks.  Returns how many were built.
+	int ProcessGenerationQueue(int maxChunks = CHUNKS_PER_FRAME) {
+		int generated = 0;
+		while (generated < maxChunks && queueHead < generateQueue.size()) {
+			ChunkCoord cc = generateQueue[queueHead++];
+			auto it = chunks.find(cc);
+			if (it != chunks.end() && it->second->generated) continue;
+			generateChunk(cc.cx, cc.cz);
+			++generated;
+		}
+		if (queueHead == generateQueue.size()) {
+			generateQueue.clear();
+			queueHead = 0;
+		}
+		return generated;
+	}
+
+	/// Rebuild dirty chunk meshes / border strips within the per-frame
+	/// budgets.  Returns the number of full chunk meshes built.
+	int RebuildDirtyMeshes() {
+		int rebuilt = 0;
+		int borders = 0;
+		for (auto& [cc, chunk] : chunks) {
+			if (!chunk->generated) continue;
+			if (chunk->meshDirty) {
+				if (rebuilt >= MESHES_PER_FRAME) continue;
+				buildChunkMesh(chunk);
+				++rebuilt;
+			} else if (chunk->borderDirty) {
+				for (int side = 0; side < 4 && borders < BORDERS_PER_FRAME; ++side) {
+					if (chunk->borderDirty & (1 << side)) {
+						buildChunkBorder(chunk, side);
+						++borders;
+					}
+				}
+			}
+			if (rebuilt >= MESHES_PER_FRAME && borders >= BORDERS_PER_FRAME) break;
+		}
+		return rebuilt;
+	}
+
+	size_t PendingGenerationCount() const { return generateQueue.size() - queueHead; }
+	size_t LoadedChunkCount() const { return chunks.size(); }
+
+	/// True when nothing is queued and every loaded chunk's mesh is current.
+	bool Idle() const {
+		if (PendingGenerationCount() != 0) return false;
+		for (const auto& kv : chunks)
+			if (kv.second->generated && (kv.second->meshDirty || kv.second->borderDirty)) return false;
+		return true;
+	}
+
+	// ---- Coordinate helpers ------------------------------------------------
+	static void GlobalToChunk(int gx, int gz, int& cx, int& cz, int& lx, int& lz) {
+		cx = (gx >= 0) ? (gx / CHUNK_SIZE) : ((gx - CHUNK_SIZE + 1) / CHUNK_SIZE);
+		cz = (gz >= 0) ? (gz / CHUNK_SIZE) : ((gz - CHUNK_SIZE + 1) / CHUNK_SIZE);
+		lx = gx - cx * CHUNK_SIZE;
+		lz = gz - cz * CHUNK_SIZE;
+	}
+
+private:
+	// Times one pipeline step if a stage timer is installed.
+	struct StageScope {
+		const VoxelWorld& world;
+		Stage stage;
+		std::chrono::steady_clock::time_point start;
+
+		StageScope(const VoxelWorld& w, Stage s) : world(w), stage(s) {
+			if (world.stageTimer) start = std::chrono::steady_clock::now();
+		}
+		~StageScope() {
+			if (!world.stageTimer) return;
+			std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+			world.stageTimer(stage, d.count());
+		}
+	};
+
+	// ---- Deterministic noise -----------------------------------------------
+	static float hashNoise(int x, int z, unsigned int seed) {
+		unsigned int n = (unsigned int)(x * 73856093) ^ (unsigned int)(z * 19349663) ^ seed;
+		n = (n << 13) ^ n;
+		n = n * (n * n * 15731u + 789221u) + 1376312589u;
+		return (float)(n & 0x7FFFFFFF) / (float)0x7FFFFFFF;
+	}
+	static float sampleNoise(int gx, int gz, int gridStep, unsigned int seed) {
+		float fx = (float)gx / (float)gridStep;
+		float fz = (float)gz / (float)gridStep;
+		int ix = (int)std::floor(fx);
+		int iz = (int)std::floor(fz);
+		float tx = fx - (float)ix;
+		float tz = fz - (float)iz;
+		tx = tx * tx * (3.0f - 2.0f * tx);
+		tz = tz * tz * (3.0f - 2.0f * tz);
+		float v00 = hashNoise(ix,     iz,     seed);
+		float v10 = hashNoise(ix + 1, iz,     seed);
+		float v01 = hashNoise(ix,     iz + 1, seed);
+		float v11 = hashNoise(ix + 1, iz + 1, seed);
+		return v00*(1-tx)*(1-tz) + v10*tx*(1-tz) + v01*(1-tx)*tz + v11*tx*tz;
+	}
+
+	// ---- Chunk lifecycle ---------------------------------------------------
+	Chunk* getOrCreateChunk(int cx, int cz) {
+		ChunkCoord cc{cx, cz};
+		auto it = chunks.find(cc);
+		if (it != chunks.end()) return it->second;
+		Chunk* c;
+		if (!chunkPool.empty()) {
+			c = chunkPool.back();
+			chunkPool.pop_back();
+			++chunkReuses;
+		} else {
+			c = new Chunk();
+			++chunkHeapAllocs;
+		}
+		c->coord = cc;
+		chunks[cc] = c;
+		return c;
+	}
+
+	void releaseChunk(Chunk* c) {
+		c->Reset();
+		chunkPool.push_back(c);
+	}
+
+	void enqueueChunk(int cx, int cz) {
+		ChunkCoord cc{cx, cz};
+		auto it = chunks.find(cc);
+		if (it != chunks.end() && it->second->generated) return;
+		for (size_t i = queueHead; i < generateQueue.size(); ++i)
+			if (generateQueue[i] == cc) return;
+		generateQueue.push_back(cc);
+	}
+
+	void generateChunk(int cx, int cz) {
+		Chunk* chunk = getOrCreateChunk(cx, cz);
+		if (chunk->generated) return;
+		StageScope timing(*this, StageGenerate);
+
+		int startGx = cx * CHUNK_SIZE;
+		int startGz = cz * CHUNK_SIZE;
+
+		ChunkStorage::BatchWriter writer(chunk->storage);
+		for (int lz = 0; lz < CHUNK_SIZE; ++lz) {
+			for (int lx = 0; lx < CHUNK_SIZE; ++lx) {
+				int gx = startGx + lx;
+				int gz = startGz + lz;
+				int height = std::min(GetTerrainHeight(gx, gz), CHUNK_HEIGHT);   // world height limit
+				for (int gy = 0; gy < height; ++gy) {
+					BlockType bt = (gy == height - 1) ? surfaceType : undergroundType;
+					writer.Set(lx, gy, lz, bt);
+				}
+			}
+		}
+		writer.Commit();
+		chunk->generated = true;
+		chunk->meshDirty = true;
+
+		// Only the neighbours' border strips facing this chunk can change,
+		// and only if they were meshed while this chunk was still missing.
+		for (int i = 0; i < 4; ++i) {
+			auto it = chunks.find({cx + kSideDx[i], cz + kSideDz[i]});
+			if (it == chunks.end() || !it->second->generated) continue;
+			int facing = i ^ 1;
+			if (it->second->missingNeighbours & (1 << facing))
+				it->second->borderDirty |= (uint8_t)(1 << facing);
+		}
+	}
+
+	void unloadChunk(int cx, int cz) {
+		ChunkCoord cc{cx, cz};
+		generateQueue.erase(
+			std::remove_if(generateQueue.begin() + queueHead, generateQueue.end(),
+				[&](const ChunkCoord& c){ return c == cc; }),
+			generateQueue.end());
+		auto it = chunks.find(cc);
+		if (it == chunks.end()) return;
+		if (sink) sink->RemoveChunk(cx, cz);
+		releaseChunk(it->second);
+		chunks.erase(it);
+	}
+
+	// An edit on a chunk edge can only change the neighbour's border strip
+	// that faces the edited block.
+	void markNeighborChunksDirty(int gx, int gz) {
+		int cx, cz, lx, lz;
+		GlobalToChunk(gx, gz, cx, cz, lx, lz);
+		if (lx == 0)              markBorderDirty(cx - 1, cz, SidePosX);
+		if (lx == CHUNK_SIZE - 1) markBorderDirty(cx + 1, cz, SideNegX);
+		if (lz == 0)              markBorderDirty(cx, cz - 1, SidePosZ);
+		if (lz == CHUNK_SIZE - 1) markBorderDirty(cx, cz + 1, SideNegZ);
+	}
+
+	void markBorderDirty(int cx, int cz, int side) {
+		auto it = chunks.find({cx, cz});
+		if (it != chunks.end()) it->second->borderDirty |= (uint8_t)(1 << side);
+	}
+
+	// ========================================================================
+	//  Mesh building — generates geometry for one chunk.
+	//  Only exposed faces (neighbour is air) are emitted.
+	//  Faces are grouped by block type so each group uses one texture.
+	//  Faces that look across a chunk edge go into that side's border strip
+	//  so they can be regenerated alone when the neighbour changes.
+	// ========================================================================
+
+	// Chunk sides, in the same order as the sink's border parts.
+	enum ChunkSide { SideNegX = 0, SidePosX, SideNegZ, SidePosZ };
+	static constexpr int kSideDx[4]   = {-1, 1, 0, 0};
+	static constexpr int kSideDz[4]   = {0, 0, -1, 1};
+	static constexpr int kSideFace[4] = {1, 0, 5, 4}; // appendFace index looking across the side
+
+	// Per-thread mesh scratch: one slot per block type for the body and each
+	// border strip.  The sink empties the vectors after use but keeps their
+	// capacity, so steady-state meshing does not allocate.
+	struct MeshScratch {
+		std::vector<VoxelMeshData> parts[IChunkMeshSink::PartCount];
+		size_t growths = 0;
+
+		MeshScratch() {
+			for (auto& p : parts) p.resize(kBlockTypeCount);
+		}
+	};
+	static MeshScratch& meshScratch() {
+		static thread_local MeshScratch scratch;
+		return scratch;
+	}
+
+	struct MeshBuilder {
+		std::vector<VoxelMeshData>& slots;
+		size_t& growths;
+
+		void add(BlockType type, float wx, float wy, float wz, float h, int face) {
+			int t = (int)type;
+			if (t < 0 || t >= kBlockTypeCount) t = (int)BlockType::Dirt;
+			VoxelMeshData& md = slots[t];
+			size_t vcap = md.vertices.capacity(), icap = md.indices.capacity();
+			appendFace(md.vertices, md.indices, wx, wy, wz, h, face);
+			if (md.vertices.capacity() != vcap || md.indices.capacity() != icap) ++growths;
+		}
+	};
+
+	MeshBuilder beginPart(int part) {
+		MeshScratch& scratch = meshScratch();
+		auto& slots = scratch.parts[part];
+		for (int t = 0; t < kBlockTypeCount; ++t) {
+			slots[t].vertices.clear();
+			slots[t].indices.clear();
+			slots[t].textureId = typeTextures[t];
+		}
+		return MeshBuilder{slots, scratch.growths};
+	}
+
+	void buildChunkMesh(Chunk* chunk) {
+		// Mesh from immutable snapshots of this chunk and its four
+		// neighbours, so the mesher never observes a half-applied edit.
+		ChunkSnapshot self = chunk->storage.Snapshot();
+		if (self.Empty()) {
+			chunk->meshDirty = false;
+			chunk->borderDirty = 0;
+			if (sink) sink->RemoveChunk(chunk->coord.cx, chunk->coord.cz);
+			return;
+		}
+		StageScope timing(*this, StageMesh);
+		const int ccx = chunk->coord.cx, ccz = chunk->coord.cz;
+		ChunkSnapshot nb[4];
+		chunk->missingNeighbours = 0;
+		for (int side = 0; side < 4; ++side) {
+			nb[side] = GetChunkSnapshot(ccx + kSideDx[side], ccz + kSideDz[side]);
+			if (!nb[side].Valid()) chunk->missingNeighbours |= (uint8_t)(1 << side);
+		}
+		auto solid = [&](int lx, int ly, int lz) -> bool {
+			if (ly < 0) return true;
+			if (lx < 0)           return nb[SideNegX].Has(lx + CHUNK_SIZE, ly, lz);
+			if (lx >= CHUNK_SIZE) return nb[SidePosX].Has(lx - CHUNK_SIZE, ly, lz);
+			if (lz < 0)           return nb[SideNegZ].Has(lx, ly, lz + CHUNK_SIZE);
+			if (lz >= CHUNK_SIZE) return nb[SidePosZ].Has(lx, ly, lz - CHUNK_SIZE);
+			return self.Has(lx, ly, lz);
+		};
+
+		MeshBuilder body = beginPart(IChunkMeshSink::PartBody);
+		MeshBuilder border[4] = {
+			beginPart(IChunkMeshSink::PartBorderNegX), beginPart(IChunkMeshSink::PartBorderPosX),
+			beginPart(IChunkMeshSink::PartBorderNegZ), beginPart(IChunkMeshSink::PartBorderPosZ),
+		};
+		int topY = 0;
+		const float h = blockSize * 0.5f;
+
+		self.ForEachBlock([&](int lx, int ly, int lz, BlockType type) {
+			topY = std::max(topY, ly);
+			float wx = (ccx * CHUNK_SIZE + lx) * blockSize;
+			float wy = ly * blockSize;
+			float wz = (ccz * CHUNK_SIZE + lz) * blockSize;
+
+			if (!solid(lx+1, ly, lz)) (lx == CHUNK_SIZE - 1 ? border[SidePosX] : body).add(type, wx, wy, wz, h, 0);
+			if (!solid(lx-1, ly, lz)) (lx == 0 ? border[SideNegX] : body).add(type, wx, wy, wz, h, 1);
+			if (!solid(lx, ly+1, lz)) body.add(type, wx, wy, wz, h, 2);
+			if (ly == 0 || !solid(lx, ly-1, lz)) body.add(type, wx, wy, wz, h, 3);
+			if (!solid(lx, ly, lz+1)) (lz == CHUNK_SIZE - 1 ? border[SidePosZ] : body).add(type, wx, wy, wz, h, 4);
+			if (!solid(lx, ly, lz-1)) (lz == 0 ? border[SideNegZ] : body).add(type, wx, wy, wz, h, 5);
+		});
+
+		const float chunkMaxY = (topY + 1) * blockSize;
+		glm::vec3 aabbMin(ccx * CHUNK_SIZE * blockSize, -0.5f * blockSize, ccz * CHUNK_SIZE * blockSize);
+		glm::vec3 aabbMax((ccx + 1) * CHUNK_SIZE * blockSize, chunkMaxY, (ccz + 1) * CHUNK_SIZE * blockSize);
+
+		if (sink) {
+			sink->UpdateChunk(ccx, ccz, aabbMin, aabbMax, body.slots);
+			for (int side = 0; side < 4; ++side)
+				sink->UpdateChunkPart(ccx, ccz, IChunkMeshSink::PartBorderNegX + side, border[side].slots);
+		}
+		chunk->meshDirty = false;
+		chunk->borderDirty = 0;
+	}
+
+	/// Regenerate only one border strip: the outward faces of the blocks on
+	/// that edge of the chunk (at most 16 x CHUNK_HEIGHT cells).
+	void buildChunkBorder(Chunk* chunk, int side) {
+		StageScope timing(*this, StageBorder);
+		ChunkSnapshot self = chunk->storage.Snapshot();
+		const int ccx = chunk->coord.cx, ccz = chunk->coord.cz;
+		ChunkSnapshot nb = GetChunkSnapshot(ccx + kSideDx[side], ccz + kSideDz[side]);
+		if (nb.Valid()) chunk->missingNeighbours &= (uint8_t)~(1 << side);
+		else            chunk->missingNeighbours |= (uint8_t)(1 << side);
+
+		MeshBuilder strip = beginPart(IChunkMeshSink::PartBorderNegX + side);
+		const float h = blockSize * 0.5f;
+		for (int s = 0; s < CHUNK_SECTIONS; ++s) {
+			if (!self.Section(s)) continue; // all air
+			for (int sy = 0; sy < CHUNK_SECTION_HEIGHT; ++sy) {
+				int ly = s * CHUNK_SECTION_HEIGHT + sy;
+				for (int i = 0; i < CHUNK_SIZE; ++i) {
+					int lx = (side == SideNegX) ? 0 : (side == SidePosX) ? CHUNK_SIZE - 1 : i;
+					int lz = (side == SideNegZ) ? 0 : (side == SidePosZ) ? CHUNK_SIZE - 1 : i;
+					BlockType type;
+					if (!self.Get(lx, ly, lz, type)) continue;
+					// Cell across the edge, in the neighbour's local coords
+					int nx = (lx + kSideDx[side] + CHUNK_SIZE) % CHUNK_SIZE;
+					int nz = (lz + kSideDz[side] + CHUNK_SIZE) % CHUNK_SIZE;
+					if (nb.Has(nx, ly, nz)) continue;
+					strip.add(type, (ccx * CHUNK_SIZE + lx) * blockSize, ly * blockSize,
+					          (ccz * CHUNK_SIZE + lz) * blockSize, h, kSideFace[side]);
+				}
+			}
+		}
+		if (sink) sink->UpdateChunkPart(ccx, ccz, IChunkMeshSink::PartBorderNegX + side, strip.slots);
+		chunk->borderDirty &= (uint8_t)~(1 << side);
+	}
+
+	// ---- Face generation ---------------------------------------------------
+	// Vertex layout: pos(3) + normal(3) + uv(2) = 8 floats
+	// Winding: CCW from outside (matches GL_CULL_FACE GL_BACK GL_CCW)
+
+	static void appendFace(std::vector<float>& verts, std::vector<unsigned int>& inds,
+	                        float cx, float cy, float cz, float h, int face)
+	{
+		unsigned int base = (unsigned int)(verts.size() / 8);
+		float v[4][8];
+		switch (face) {
+		case 0: // +X
+			v[0][0]=cx+h; v[0][1]=cy-h; v[0][2]=cz-h; v[0][3]= 1; v[0][4]=0; v[0][5]=0; v[0][6]=0; v[0][7]=0;
+			v[1][0]=cx+h; v[1][1]=cy+h; v[1][2]=cz-h; v[1][3]= 1; v[1][4]=0; v[1][5]=0; v[1][6]=0; v[1][7]=1;
+			v[2][0]=cx+h; v[2][1]=cy+h; v[2][2]=cz+h; v[2][3]= 1; v[2][4]=0; v[2][5]=0; v[2][6]=1; v[2][7]=1;
+			v[3][0]=cx+h; v[3][1]=cy-h; v[3][2]=cz+h; v[3][3]= 1; v[3][4]=0; v[3][5]=0; v[3][6]=1; v[3][7]=0;
+			break;
+		case 1: // -X
+			v[0][0]=cx-h; v[0][1]=cy-h; v[0][2]=cz+h; v[0][3]=-1; v[0][4]=0; v[0][5]=0; v[0][6]=0; v[0][7]=0;
+			v[1][0]=cx-h; v[1][1]=cy+h; v[1][2]=cz+h; v[1][3]=-1; v[1][4]=0; v[1][5]=0; v[1][6]=0; v[1][7]=1;
+			v[2][0]=cx-h; v[2][1]=cy+h; v[2][2]=cz-h; v[2][3]=-1; v[2][4]=0; v[2][5]=0; v[2][6]=1; v[2][7]=1;
+			v[3][0]=cx-h; v[3][1]=cy-h; v[3][2]=cz-h; v[3][3]=-1; v[3][4]=0; v[3][5]=0; v[3][6]=1; v[3][7]=0;
+			break;
+		case 2: // +Y
+			v[0][0]=cx-h; v[0][1]=cy+h; v[0][2]=cz-h; v[0][3]=0; v[0][4]= 1; v[0][5]=0; v[0][6]=0; v[0][7]=0;
+			v[1][0]=cx-h; v[1][1]=cy+h; v[1][2]=cz+h; v[1][3]=0; v[1][4]= 1; v[1][5]=0; v[1][6]=0; v[1][7]=1;
+			v[2][0]=cx+h; v[2][1]=cy+h; v[2][2]=cz+h; v[2][3]=0; v[2][4]= 1; v[2][5]=0; v[2][6]=1; v[2][7]=1;
+			v[3][0]=cx+h; v[3][1]=cy+h; v[3][2]=cz-h; v[3][3]=0; v[3][4]= 1; v[3][5]=0; v[3][6]=1; v[3][7]=0;
+			break;
+		case 3: // -Y
+			v[0][0]=cx-h; v[0][1]=cy-h; v[0][2]=cz+h; v[0][3]=0; v[0][4]=-1; v[0][5]=0; v[0][6]=0; v[0][7]=0;
+			v[1][0]=cx-h; v[1][1]=cy-h; v[1][2]=cz-h; v[1][3]=0; v[1][4]=-1; v[1][5]=0; v[1][6]=0; v[1][7]=1;
+			v[2][0]=cx+h; v[2][1]=cy-h; v[2][2]=cz-h; v[2][3]=0; v[2][4]=-1; v[2][5]=0; v[2][6]=1; v[2][7]=1;
+			v[3][0]=cx+h; v[3][1]=cy-h; v[3][2]=cz+h; v[3][3]=0; v[3][4]=-1; v[3][5]=0; v[3][6]=1; v[3][7]=0;
+			break;
+		case 4: // +Z
+			v[0][0]=cx-h; v[0][1]=cy-h; v[0][2]=cz+h; v[0][3]=0; v[0][4]=0; v[0][5]= 1; v[0][6]=0; v[0][7]=0;
+			v[1][0]=cx+h; v[1][1]=cy-h; v[1][2]=cz+h; v[1][3]=0; v[1][4]=0; v[1][5]= 1; v[1][6]=1; v[1][7]=0;
+			v[2][0]=cx+h; v[2][1]=cy+h; v[2][2]=cz+h; v[2][3]=0; v[2][4]=0; v[2][5]= 1; v[2][6]=1; v[2][7]=1;
+			v[3][0]=cx-h; v[3][1]=cy+h; v[3][2]=cz+h; v[3][3]=0; v[3][4]=0; v[3][5]= 1; v[3][6]=0; v[3][7]=1;
+			break;
+		case 5: // -Z
+			v[0][0]=cx+h; v[0][1]=cy-h; v[0][2]=cz-h; v[0][3]=0; v[0][4]=0; v[0][5]=-1; v[0][6]=0; v[0][7]=0;
+			v[1][0]=cx-h; v[1][1]=cy-h; v[1][2]=cz-h; v[1][3]=0; v[1][4]=0; v[1][5]=-1; v[1][6]=1; v[1][7]=0;
+			v[2][0]=cx-h; v[2][1]=cy+h; v[2][2]=cz-h; v[2][3]=0; v[2][4]=0; v[2][5]=-1; v[2][6]=1; v[2][7]=1;
+			v[3][0]=cx+h; v[3][1]=cy+h; v[3][2]=cz-h; v[3][3]=0; v[3][4]=0; v[3][5]=-1; v[3][6]=0; v[3][7]=1;
+			break;
+		}
+		for (int i = 0; i < 4; ++i)
+			for (int j = 0; j < 8; ++j)
+				verts.push_back(v[i][j]);
+		inds.push_back(base);     inds.push_back(base + 1); inds.push_back(base + 2);
+		inds.push_back(base);     inds.push_back(base + 2); inds.push_back(base + 3);
+	}
+
+private:
+	float blockSize;
+	int renderDistance;
+	unsigned int worldSeed;
+	int baseHeight, maxHillHeight;
+	BlockType surfaceType, undergroundType;
+
+	IChunkMeshSink* sink = nullptr;
+	std::array<unsigned int, kBlockTypeCount> typeTextures{};
+	StageTimer stageTimer;
+
+	// Map nodes come from a pool allocator and Chunk objects from chunkPool,
+	// so streaming chunks in and out recycles memory instead of reallocating.
+	std::unordered_map<ChunkCoord, Chunk*, ChunkCoordHash, std::equal_to<ChunkCoord>,
+	                   PoolAllocator<std::pair<const ChunkCoord, Chunk*>>> chunks;
+	std::vector<Chunk*> chunkPool;
+	std::vector<ChunkCoord> generateQueue;
+	size_t queueHead = 0;
+	std::vector<ChunkCoord> toUnload; // scratch for StreamAround
+	size_t chunkHeapAllocs = 0;
+	size_t chunkReuses = 0;
+	static constexpr int CHUNKS_PER_FRAME = 8;
+	static constexpr int MESHES_PER_FRAME = 8;
+	static constexpr int BORDERS_PER_FRAME = 32;
+
+	int lastPlayerCx, lastPlayerCz;
+};
@@ -42,8 +42,9 @@ void GameScene::Update()
 
 void GameScene::GenBackground()
 {
-    std::vector<unsigned char> block_light_img = Engine::GetResourcesArchive()->GetFile("block_sgreen.png");
-    std::vector<unsigned char> block_dark_img = Engine::GetResourcesArchive()->GetFile("block_tgreen.png");
+    // Every tile shares one of these two textures
+    TextureHandle block_light_img = ResourceManager::Get().AcquireTexture(Engine::GetResourcesArchive()->GetFile("block_sgreen.png"));
+    TextureHandle block_dark_img = ResourceManager::Get().AcquireTexture(Engine::GetResourcesArchive()->GetFile("block_tgreen.png"));
 
     for (int j = 0; j < block_count.y; j++)
         for (int i = 0; i < block_count.x; i++)
@@ -7,16 +7,18 @@
 void HotbarComponent::Init()
 {
     selectedSlot = BlockType::Dirt;
+    slotTexture = ResourceManager::Get().AcquireTexture(Engine::GetResourcesArchive()->GetFile("hotbar_slot.png"));
+    selectedSlotTexture = ResourceManager::Get().AcquireTexture(Engine::GetResourcesArchive()->GetFile("hotbar_slot_selected.png"));
     for (int i = 0; i < 9; ++i)
     {
         Object *slot = CreateObject();
         slot->SetLayer(900);
         slot->SetPosition(Vector2((i - 5) * 40.0f, 0) + object->GetPosition());
-        slot->AddComponent(new Image(Engine::GetResourcesArchive()->GetFile("hotbar_slot.png")));
+        slot->AddComponent(new Image(slotTexture));
         hotbarSlots.push_back(slot);
     }
     selectedSlotIndex=0; 
-    hotbarSlots[selectedSlotIndex]->GetComponent<Image>()->SetNewSprite(Engine::GetResourcesArchive()->GetFile("hotbar_slot_selected.png"));
+    hotbarSlots[selectedSlotIndex]->GetComponent<Image>()->SetTexture(selectedSlotTexture);
 
 }
 
@@ -25,10 +27,10 @@ void HotbarComponent::SetSelectedSlot(int slot)
     selectedSlotIndex = slot;
     for (size_t i = 0; i < hotbarSlots.size(); ++i)
     {
-        hotbarSlots[i]->GetComponent<Image>()->SetNewSprite(Engine::GetResourcesArchive()->GetFile("hotbar_slot.png"));
+        hotbarSlots[i]->GetComponent<Image>()->SetTexture(slotTexture);
     }
     selectedSlot = static_cast<BlockType>(slot);
-    hotbarSlots[selectedSlotIndex]->GetComponent<Image>()->SetNewSprite(Engine::GetResourcesArchive()->GetFile("hotbar_slot_selected.png"));
+    hotbarSlots[selectedSlotIndex]->GetComponent<Image>()->SetTexture(selectedSlotTexture);
 }
 
 void HotbarComponent::Update()
@@ -19,7 +19,10 @@ void MinecraftCloneScene::Init()
     light->SetColor(glm::vec3(1.0f, 1.0f, 1.0f));
     light->SetAmbient(glm::vec3(0.25f, 0.25f, 0.25f));
     light->SetShadowEnabled(true);
-    light->SetShadowMapSize(4096, 4096);
+    light->SetShadowMapSize(2048, 2048);      // per cascade
+    light->SetCascadeCount(3);
+    light->SetShadowDistance(90.0f);          // ~render distance 10
+    light->SetShadowQuality(LightComponent::ShadowMedium); // 9 hardware PCF taps
     lightObj->AddComponent(light);
 
     // ---- World grid (chunk-based, infinite) --------------------------------
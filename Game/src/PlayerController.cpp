@@ -7,6 +7,7 @@ void PlayerController::SetHotbar(HotbarComponent *hb)
     hotbar = hb;
 }
 
+// Per frame: looking around and UI input stay at the display rate.
 void PlayerController::Update(float dt)
 {
     if (!object)
@@ -20,6 +21,33 @@ void PlayerController::Update(float dt)
     pitch += mouseDelta.y * mouseSensitivity;
     pitch = std::max(-89.0f, std::min(89.0f, pitch));
 
+    // ---- Hotbar slot selection (keys 1-9) ----------------------------------
+    for (int i = 0; i < 9; ++i)
+    {
+        if (input.IsKeyDown(SDLK_1 + i))
+        {
+            if (hotbar)
+                hotbar->SetSelectedSlot(i);
+            break;
+        }
+    }
+
+    if (cameraObject)
+        cameraObject->SetRotation(Vector3(pitch, yaw, 0.0f));
+
+    // ---- Highlight block under crosshair --------------------------------
+    updateHoveredBlock(findGrid(), dt);
+}
+
+// Fixed step: movement, gravity and collisions run at the tick rate, so
+// jump height and fall speed are the same at any frame rate.
+void PlayerController::FixedUpdate(float dt)
+{
+    if (!object)
+        return;
+
+    auto &input = InputManager::Get();
+
     Vector3 pos = object->GetPosition3D();
     WorldGridComponent *grid = findGrid();
 
@@ -87,17 +115,6 @@ void PlayerController::Update(float dt)
         isGrounded = false;
     }
 
-    // ---- Hotbar slot selection (keys 1-9) ----------------------------------
-    for (int i = 0; i < 9; ++i)
-    {
-        if (input.IsKeyDown(SDLK_1 + i))
-        {
-            if (hotbar)
-                hotbar->SetSelectedSlot(i);
-            break;
-        }
-    }
-
     velocityY += gravity * dt;
     pos.y += velocityY * dt;
 
@@ -133,15 +150,9 @@ void PlayerController::Update(float dt)
 
     object->SetPosition(pos);
 
-    // ---- Sync camera to player eye position ----------------------------
+    // ---- Move camera to the eye position (drawn interpolated) -----------
     if (cameraObject)
-    {
         cameraObject->SetPosition(Vector3(pos.x, pos.y + eyeHeight, pos.z));
-        cameraObject->SetRotation(Vector3(pitch, yaw, 0.0f));
-    }
-
-    // ---- Highlight block under crosshair --------------------------------
-    updateHoveredBlock(grid, dt);
 }
 
 void PlayerController::OnMouseButtonDown(Vector2)
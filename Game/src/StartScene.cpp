@@ -17,7 +17,6 @@ void StartScene::Init()
     my3DObject->SetLayer(200); 
     Vector2 windowSize(1280, 720);
     SetWindowSize(windowSize.x, windowSize.y);
-    glViewport(0, 0, windowSize.x, windowSize.y);
     UIdraw();
 }
 void StartScene::UIdraw()
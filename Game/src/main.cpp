@@ -25,6 +25,7 @@ class Game : public Engine {
 int main(int argc, char* argv[]) 
 {
     Game game; 
+    game.ParseCommandLine(argc, argv);
     game.Run();
 
     return 0;